@@ -0,0 +1,379 @@
+/**
+ * bench.c
+ * Microbenchmarks for the simulator's hot paths: scheduler dispatch,
+ * page-fault handling, file create/delete/lookup, disk scheduling, the
+ * discrete-event engine and the run summary kernels, each driven by the
+ * seeded workload generators.
+ * Every (benchmark, workload) pair runs in its own child process and prints
+ * one JSON object per line so runs, and their peak memory, can be diffed
+ * and tracked.
+ *
+ * Usage: myos_bench [-s seed] [-x scale] [-b bench] [-w workload]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "scheduler.h"
+#include "memory.h"
+#include "filesystem.h"
+#include "disk.h"
+#include "simlog.h"
+#include "workload.h"
+#include "event.h"
+#include "procsim.h"
+#include "procstats.h"
+
+#define BENCH_FS_NAMES 64
+#define BENCH_MEM_PROCESSES 4
+#define BENCH_DISK_TRACE 10000
+#define BENCH_EVENTS_PENDING 4096
+#define BENCH_STATS_PROCESSES 2000000
+
+typedef struct {
+    long ops;
+    double seconds;
+    char extra[160]; // JSON members specific to the benchmark, without braces
+} BenchResult;
+
+typedef void (*BenchFn)(int kind, long target_ops, unsigned long long seed, BenchResult* r);
+
+typedef struct {
+    const char* name;
+    BenchFn run;
+    long default_ops;
+} Bench;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Runs one (benchmark, workload) pair in a forked child, so max_rss_kb is
+// that run's own peak rather than the highest of every run before it.
+// Returns -1 if the child could not run or died.
+static int run_isolated(const Bench* b, int kind, long target, unsigned long long seed,
+                        BenchResult* r, long* max_rss_kb) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        b->run(kind, target, seed, r);
+        // Smaller than PIPE_BUF, so the write is atomic
+        ssize_t written = write(fds[1], r, sizeof(*r));
+        _exit(written == (ssize_t)sizeof(*r) ? 0 : 1);
+    }
+    close(fds[1]);
+    ssize_t got = read(fds[0], r, sizeof(*r));
+    close(fds[0]);
+    int status;
+    struct rusage ru;
+    if (wait4(pid, &status, 0, &ru) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+        got != (ssize_t)sizeof(*r)) {
+        return -1;
+    }
+    *max_rss_kb = ru.ru_maxrss;
+    return 0;
+}
+
+// One op is one CPU dispatch. Each run schedules a full ready queue whose
+// burst lengths and arrivals come from the workload.
+static void bench_sched_dispatch(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    Workload w;
+    workload_init(&w, kind, 64, seed);
+    const int time_quantum = 4;
+    long runs = 0;
+    double start = now_seconds();
+    r->ops = 0;
+    while (r->ops < target_ops) {
+        Process procs[MAX_PROCESSES];
+        int arrival = 0;
+        for (int i = 0; i < MAX_PROCESSES; i++) {
+            procs[i].pid = i + 1;
+            procs[i].arrival_time = arrival;
+            procs[i].burst_time = 1 + workload_next_key(&w);
+            arrival += (int)workload_next_gap(&w, 3);
+            r->ops += (procs[i].burst_time + time_quantum - 1) / time_quantum;
+        }
+        simulate_round_robin(procs, MAX_PROCESSES, time_quantum);
+        runs++;
+    }
+    r->seconds = now_seconds() - start;
+    snprintf(r->extra, sizeof(r->extra), "\"runs\":%ld,\"processes_per_run\":%d", runs, MAX_PROCESSES);
+}
+
+// One op is one page access across a few processes competing for the frames.
+static void bench_page_fault(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    static ProcessMemoryInfo infos[BENCH_MEM_PROCESSES];
+    Workload w;
+    workload_init(&w, kind, BENCH_MEM_PROCESSES * MAX_PAGES_PER_PROCESS, seed);
+    init_memory_management();
+    for (int p = 0; p < BENCH_MEM_PROCESSES; p++) request_memory(&infos[p], 100 + p, MAX_PAGES_PER_PROCESS);
+
+    double start = now_seconds();
+    for (long i = 0; i < target_ops; i++) {
+        int key = workload_next_key(&w);
+        int p = key / MAX_PAGES_PER_PROCESS;
+        access_memory(&infos[p], infos[p].pid, key % MAX_PAGES_PER_PROCESS);
+    }
+    r->seconds = now_seconds() - start;
+    r->ops = target_ops;
+    snprintf(r->extra, sizeof(r->extra), "\"page_faults\":%d,\"fault_rate\":%.4f,\"frames\":%d",
+             get_page_fault_count(), target_ops > 0 ? (double)get_page_fault_count() / target_ops : 0.0, NUM_FRAMES);
+}
+
+// One op is a lookup (50%), create (25%) or delete (25%) of a workload-chosen name.
+static void bench_fs_ops(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    static char names[BENCH_FS_NAMES][MAX_FILENAME_LEN];
+    for (int i = 0; i < BENCH_FS_NAMES; i++) snprintf(names[i], MAX_FILENAME_LEN, "file_%d.dat", i);
+    Workload w;
+    workload_init(&w, kind, BENCH_FS_NAMES, seed);
+    init_filesystem();
+
+    long lookups = 0, found = 0;
+    double start = now_seconds();
+    for (long i = 0; i < target_ops; i++) {
+        const char* name = names[workload_next_key(&w)];
+        unsigned int op = (unsigned int)(workload_rand(&w) & 3);
+        if (op < 2) {
+            lookups++;
+            if (find_file_sim(name) != -1) found++;
+        } else if (op == 2) {
+            create_file_sim(name, 16);
+        } else {
+            delete_file_sim(name);
+        }
+    }
+    r->seconds = now_seconds() - start;
+    r->ops = target_ops;
+    snprintf(r->extra, sizeof(r->extra), "\"lookups\":%ld,\"lookup_hit_rate\":%.4f,\"max_files\":%d",
+             lookups, lookups > 0 ? (double)found / lookups : 0.0, MAX_FILES);
+}
+
+// One op is one request replayed through the queue (merging and plugging on).
+static void bench_disk(int kind, long target_ops, unsigned long long seed, int sched, BenchResult* r) {
+    DiskModel model;
+    disk_default_model(&model);
+    DiskQueueConfig cfg;
+    disk_default_queue_config(&cfg, sched);
+    int blocks = model.total_cylinders * model.sectors_per_cylinder / 8;
+    Workload w;
+    workload_init(&w, kind, blocks, seed);
+
+    DiskRequest* trace = malloc(BENCH_DISK_TRACE * sizeof(DiskRequest));
+    if (trace == NULL) {
+        r->ops = 0;
+        r->seconds = 0;
+        snprintf(r->extra, sizeof(r->extra), "\"error\":\"out of memory\"");
+        return;
+    }
+    long head_movement = 0, dispatched = 0;
+    double p99 = 0;
+    r->ops = 0;
+    r->seconds = 0;
+    while (r->ops < target_ops) {
+        long t = 0;
+        for (int i = 0; i < BENCH_DISK_TRACE; i++) {
+            t += workload_next_gap(&w, 6000);
+            trace[i].arrival_time = t;
+            trace[i].sector = workload_next_key(&w) * 8;
+            trace[i].size = 8;
+            trace[i].is_write = (workload_rand(&w) % 3) == 0;
+        }
+        DiskRunStats stats;
+        double start = now_seconds();
+        disk_replay(trace, BENCH_DISK_TRACE, 0, &model, &cfg, &stats, NULL, NULL, NULL);
+        r->seconds += now_seconds() - start;
+        r->ops += BENCH_DISK_TRACE;
+        head_movement += stats.head_movement;
+        dispatched += stats.dispatched;
+        if (stats.read_p99_latency > p99) p99 = stats.read_p99_latency;
+    }
+    free(trace);
+    snprintf(r->extra, sizeof(r->extra), "\"dispatched\":%ld,\"head_movement\":%ld,\"read_p99_us\":%.0f",
+             dispatched, head_movement, p99);
+}
+
+static void bench_disk_fcfs(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    bench_disk(kind, target_ops, seed, DISK_SCHED_FCFS, r);
+}
+
+static void bench_disk_deadline(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    bench_disk(kind, target_ops, seed, DISK_SCHED_DEADLINE, r);
+}
+
+// Hold model: every fired event posts one more after a delay drawn from the
+// workload's keys, keeping BENCH_EVENTS_PENDING events in the heap. Uniform
+// keys spread the delays, sequential ones sweep them, zipf piles events into
+// the near future and bursty posts runs of neighbouring times. One op is one
+// event.
+typedef struct {
+    EventEngine* engine;
+    Workload* w;
+    long remaining;
+} HoldState;
+
+static long hold_delay(Workload* w) {
+    return 1 + 2L * workload_next_key(w); // Keys 0..1023: a mean near 1000us when uniform
+}
+
+static void hold_event(void* ctx, long arg) {
+    HoldState* h = ctx;
+    if (h->remaining-- > 0) event_post(h->engine, hold_delay(h->w), hold_event, h, arg);
+}
+
+static void bench_event_engine(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    EventEngine engine;
+    event_engine_init(&engine);
+    Workload w;
+    workload_init(&w, kind, 1024, seed);
+    HoldState h = {&engine, &w, target_ops - BENCH_EVENTS_PENDING};
+    for (int i = 0; i < BENCH_EVENTS_PENDING; i++) event_post(&engine, hold_delay(&w), hold_event, &h, i);
+
+    double start = now_seconds();
+    r->ops = event_run(&engine, -1);
+    r->seconds = now_seconds() - start;
+    snprintf(r->extra, sizeof(r->extra), "\"pending\":%d,\"simulated_us\":%ld", BENCH_EVENTS_PENDING, engine.now);
+    event_engine_destroy(&engine);
+}
+
+// Full-system model: programs arrive with workload gaps and run their whole
+// lifecycle through the CPU, pager, file system and disk. One op is one event.
+static void bench_process_sim(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    static const SimProgram programs[] = {
+        {"editor", 4, "mydoc.txt", 20000},
+        {"compiler", 6, "source.c", 80000},
+        {"player", 2, "song.mp3", 40000},
+    };
+    EventEngine engine;
+    event_engine_init(&engine);
+    SimConfig cfg;
+    procsim_default_config(&cfg);
+    ProcTable table;
+    proctable_init(&table);
+    SimSystem sys;
+    procsim_init(&sys, &engine, &table, &cfg);
+    init_memory_management();
+    init_filesystem();
+    Workload w;
+    workload_init(&w, kind, 3, seed);
+
+    long procs = target_ops / 30 + 1; // A process fires about 30 events
+    long arrival = 0;
+    for (long i = 0; i < procs; i++) {
+        arrival += workload_next_gap(&w, 200000);
+        procsim_spawn(&sys, &programs[workload_next_key(&w)], arrival);
+    }
+    double start = now_seconds();
+    r->ops = procsim_run(&sys);
+    r->seconds = now_seconds() - start;
+    snprintf(r->extra, sizeof(r->extra), "\"processes\":%d,\"page_faults\":%ld,\"disk_ios\":%ld,\"simulated_us\":%ld",
+             sys.finished, sys.page_faults, sys.disk_ios, sys.last_exit);
+    procsim_destroy(&sys);
+    proctable_destroy(&table);
+    event_engine_destroy(&engine);
+}
+
+// One op is one finished process folded into the run summary (averages,
+// deviations, percentiles and fairness over the column store).
+static void bench_proc_stats(int kind, long target_ops, unsigned long long seed, BenchResult* r) {
+    long n = target_ops < BENCH_STATS_PROCESSES ? target_ops : BENCH_STATS_PROCESSES;
+    ProcStore store;
+    procstore_init(&store);
+    Workload w;
+    workload_init(&w, kind, 1000, seed);
+    if (n < 1 || procstore_reserve(&store, n) != 0) {
+        r->ops = 0;
+        r->seconds = 0;
+        snprintf(r->extra, sizeof(r->extra), "\"error\":\"out of memory\"");
+        procstore_free(&store);
+        return;
+    }
+    long arrival = 0;
+    for (long i = 0; i < n; i++) {
+        long burst = 1 + workload_next_key(&w);
+        long waiting = workload_next_gap(&w, 2000);
+        arrival += workload_next_gap(&w, 500);
+        procstore_add(&store, arrival, burst, arrival + burst + waiting, waiting);
+    }
+
+    ProcSummary sum;
+    r->ops = 0;
+    double start = now_seconds();
+    while (r->ops < target_ops) {
+        procstore_summarize(&store, &sum);
+        r->ops += n;
+    }
+    r->seconds = now_seconds() - start;
+    snprintf(r->extra, sizeof(r->extra), "\"processes\":%ld,\"turnaround_p99\":%ld,\"waiting_p99\":%ld,\"fairness\":%.4f",
+             n, sum.turnaround.p99, sum.waiting.p99, sum.fairness);
+    procstore_free(&store);
+}
+
+static const Bench benches[] = {
+    {"sched_dispatch", bench_sched_dispatch, 2000000},
+    {"page_fault", bench_page_fault, 5000000},
+    {"fs_ops", bench_fs_ops, 2000000},
+    {"disk_fcfs", bench_disk_fcfs, 200000},
+    {"disk_deadline", bench_disk_deadline, 200000},
+    {"event_engine", bench_event_engine, 10000000},
+    {"process_sim", bench_process_sim, 2000000},
+    {"proc_stats", bench_proc_stats, 20000000},
+};
+#define NUM_BENCHES (int)(sizeof(benches) / sizeof(benches[0]))
+
+int main(int argc, char* argv[]) {
+    unsigned long long seed = 42;
+    double scale = 1.0;
+    const char* only_bench = NULL;
+    const char* only_workload = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc) scale = atof(argv[++i]);
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) only_bench = argv[++i];
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) only_workload = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [-s seed] [-x scale] [-b bench] [-w workload]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (scale <= 0) scale = 1.0;
+
+    sim_verbose = 0;
+    for (int b = 0; b < NUM_BENCHES; b++) {
+        if (only_bench && strcmp(only_bench, benches[b].name) != 0) continue;
+        for (int kind = 0; kind < WORKLOAD_KINDS; kind++) {
+            if (only_workload && strcmp(only_workload, workload_name(kind)) != 0) continue;
+            BenchResult r;
+            long target = (long)(benches[b].default_ops * scale);
+            if (target < 1) target = 1;
+            r.extra[0] = '\0';
+            long rss_kb;
+            if (run_isolated(&benches[b], kind, target, seed, &r, &rss_kb) != 0) {
+                fprintf(stderr, "%s/%s: benchmark process failed\n", benches[b].name, workload_name(kind));
+                continue;
+            }
+            double ns_per_op = r.ops > 0 ? r.seconds * 1e9 / r.ops : 0;
+            double ops_per_sec = r.seconds > 0 ? r.ops / r.seconds : 0;
+            printf("{\"bench\":\"%s\",\"workload\":\"%s\",\"seed\":%llu,\"ops\":%ld,\"seconds\":%.6f,"
+                   "\"ns_per_op\":%.2f,\"ops_per_sec\":%.0f,\"max_rss_kb\":%ld%s%s}\n",
+                   benches[b].name, workload_name(kind), seed, r.ops, r.seconds, ns_per_op, ops_per_sec,
+                   rss_kb, r.extra[0] ? "," : "", r.extra);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h> // For abs()
+#include <string.h>
 #include "disk.h"
+#include "metrics.h"
 
 void simulate_fcfs_disk_scheduling(int requests[], int num_requests, int initial_head_pos, int total_cylinders) {
     printf("\n## FCFS Disk Scheduling Simulation ##\n");
@@ -35,8 +37,680 @@ void simulate_fcfs_disk_scheduling(int requests[], int num_requests, int initial
             continue;
         }
         total_head_movement += abs(requests[i] - current_head_pos);
+        metric_inc(&metric_disk_requests);
+        metric_inc(&metric_disk_dispatches);
+        metric_observe(&metric_disk_seek_distance, abs(requests[i] - current_head_pos));
         current_head_pos = requests[i];
         printf(" -> %d", current_head_pos);
     }
     printf("\nTotal Head Movement: %d cylinders.\n", total_head_movement);
 }
+
+/*
+ * Dynamic request queue.
+ * Requests arrive over time instead of all existing at time zero. Adjacent
+ * requests in the same direction are merged at the back and the front of
+ * queued ones, an idle queue can be plugged so a batch builds up before the
+ * head starts moving, and the deadline scheduler serves sector-sorted batches
+ * while bounding how long a read can starve.
+ */
+#define DISK_MERGE_LOOKBACK 8
+
+typedef struct {
+    int sector;
+    int size;
+    int is_write;
+    long deadline;
+    long seq;          // Queue order, used by FCFS
+    int first_member;  // Trace indices folded into this request, chained via member_next
+    int last_member;
+    int fifo_prev;
+    int fifo_next;
+} QueuedRequest;
+
+typedef struct {
+    QueuedRequest* slots;
+    int* free_slots;
+    int num_free;
+    int* sorted;       // Slot indices ordered by starting sector
+    int count;
+    int fifo_head[2];  // Per-direction arrival FIFOs, indexed by DISK_READ/DISK_WRITE
+    int fifo_tail[2];
+    int* member_next;
+    long next_seq;
+    int batch_dir;
+    int batch_left;
+    int next_sector;
+    int starved;
+} DiskQueue;
+
+void disk_default_model(DiskModel* model) {
+    model->total_cylinders = DISK_DEFAULT_CYLINDERS;
+    model->sectors_per_cylinder = DISK_SECTORS_PER_CYLINDER;
+    model->seek_settle = 500;
+    model->seek_per_cylinder = 20;
+    model->rotational_latency = 4000;
+    model->transfer_per_sector = 10;
+}
+
+// Flash device: no head to move, a short fixed access time and fast transfer.
+void disk_ssd_model(DiskModel* model) {
+    disk_default_model(model);
+    model->seek_settle = 0;
+    model->seek_per_cylinder = 0;
+    model->rotational_latency = 60;
+    model->transfer_per_sector = 2;
+}
+
+void disk_default_queue_config(DiskQueueConfig* cfg, int sched) {
+    cfg->sched = sched;
+    cfg->merge = 1;
+    cfg->plug = 1;
+    cfg->plug_delay = 3000;
+    cfg->plug_max = 16;
+    cfg->max_merge_sectors = 256;
+    cfg->read_expire = 500000;
+    cfg->write_expire = 5000000;
+    cfg->fifo_batch = 16;
+    cfg->writes_starved = 2;
+}
+
+long disk_service_time(const DiskModel* model, int from_cylinder, int sector, int size) {
+    int distance = abs(sector / model->sectors_per_cylinder - from_cylinder);
+    long t = (long)model->rotational_latency + (long)size * model->transfer_per_sector;
+    if (distance > 0) {
+        t += model->seek_settle + (long)distance * model->seek_per_cylinder;
+    }
+    return t;
+}
+
+static int queue_lower_bound(const DiskQueue* q, int sector) {
+    int lo = 0, hi = q->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (q->slots[q->sorted[mid]].sector < sector) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void queue_insert_sorted(DiskQueue* q, int slot) {
+    int pos = queue_lower_bound(q, q->slots[slot].sector);
+    memmove(&q->sorted[pos + 1], &q->sorted[pos], (size_t)(q->count - pos) * sizeof(int));
+    q->sorted[pos] = slot;
+    q->count++;
+}
+
+static void queue_remove_sorted(DiskQueue* q, int slot) {
+    int pos = queue_lower_bound(q, q->slots[slot].sector);
+    while (pos < q->count && q->sorted[pos] != slot) pos++;
+    if (pos == q->count) return;
+    memmove(&q->sorted[pos], &q->sorted[pos + 1], (size_t)(q->count - pos - 1) * sizeof(int));
+    q->count--;
+}
+
+static void fifo_append(DiskQueue* q, int slot) {
+    int dir = q->slots[slot].is_write;
+    q->slots[slot].fifo_next = -1;
+    q->slots[slot].fifo_prev = q->fifo_tail[dir];
+    if (q->fifo_tail[dir] != -1) q->slots[q->fifo_tail[dir]].fifo_next = slot;
+    else q->fifo_head[dir] = slot;
+    q->fifo_tail[dir] = slot;
+}
+
+static void fifo_insert_before(DiskQueue* q, int slot, int before) {
+    int dir = q->slots[slot].is_write;
+    int prev = q->slots[before].fifo_prev;
+    q->slots[slot].fifo_prev = prev;
+    q->slots[slot].fifo_next = before;
+    q->slots[before].fifo_prev = slot;
+    if (prev != -1) q->slots[prev].fifo_next = slot;
+    else q->fifo_head[dir] = slot;
+}
+
+static void fifo_remove(DiskQueue* q, int slot) {
+    int dir = q->slots[slot].is_write;
+    int prev = q->slots[slot].fifo_prev, next = q->slots[slot].fifo_next;
+    if (prev != -1) q->slots[prev].fifo_next = next;
+    else q->fifo_head[dir] = next;
+    if (next != -1) q->slots[next].fifo_prev = prev;
+    else q->fifo_tail[dir] = prev;
+}
+
+static void queue_release(DiskQueue* q, int slot) {
+    queue_remove_sorted(q, slot);
+    fifo_remove(q, slot);
+    q->free_slots[q->num_free++] = slot;
+}
+
+// Folds queued request 'b' into 'a', which sits directly in front of it on disk.
+static void queue_coalesce(DiskQueue* q, int a, int b) {
+    QueuedRequest* ra = &q->slots[a];
+    QueuedRequest* rb = &q->slots[b];
+    ra->size += rb->size;
+    q->member_next[ra->last_member] = rb->first_member;
+    ra->last_member = rb->last_member;
+    if (rb->deadline < ra->deadline) ra->deadline = rb->deadline;
+    if (rb->seq < ra->seq) {
+        // Take over the older request's place in the FIFO so expiry stays ordered
+        ra->seq = rb->seq;
+        fifo_remove(q, a);
+        fifo_insert_before(q, a, b);
+    }
+    queue_release(q, b);
+}
+
+static int queue_init(DiskQueue* q, int capacity) {
+    q->slots = malloc((size_t)capacity * sizeof(QueuedRequest));
+    q->free_slots = malloc((size_t)capacity * sizeof(int));
+    q->sorted = malloc((size_t)capacity * sizeof(int));
+    q->member_next = malloc((size_t)capacity * sizeof(int));
+    if (!q->slots || !q->free_slots || !q->sorted || !q->member_next) {
+        free(q->slots); free(q->free_slots); free(q->sorted); free(q->member_next);
+        return -1;
+    }
+    for (int i = 0; i < capacity; i++) q->free_slots[i] = capacity - 1 - i;
+    q->num_free = capacity;
+    q->count = 0;
+    q->fifo_head[0] = q->fifo_head[1] = -1;
+    q->fifo_tail[0] = q->fifo_tail[1] = -1;
+    q->next_seq = 0;
+    q->batch_dir = DISK_READ;
+    q->batch_left = 0;
+    q->next_sector = 0;
+    q->starved = 0;
+    return 0;
+}
+
+static void queue_destroy(DiskQueue* q) {
+    free(q->slots);
+    free(q->free_slots);
+    free(q->sorted);
+    free(q->member_next);
+}
+
+static void queue_add(DiskQueue* q, const DiskQueueConfig* cfg, const DiskRequest* r, int member, long now, DiskRunStats* stats) {
+    long deadline = now + (r->is_write ? cfg->write_expire : cfg->read_expire);
+    q->member_next[member] = -1;
+
+    if (cfg->merge) {
+        int pos = queue_lower_bound(q, r->sector);
+
+        // Back merge: a queued request ends exactly where this one starts
+        for (int j = pos - 1; j >= 0 && j >= pos - DISK_MERGE_LOOKBACK; j--) {
+            int s = q->sorted[j];
+            QueuedRequest* e = &q->slots[s];
+            if (e->is_write == r->is_write && e->sector + e->size == r->sector &&
+                e->size + r->size <= cfg->max_merge_sectors) {
+                e->size += r->size;
+                q->member_next[e->last_member] = member;
+                e->last_member = member;
+                stats->back_merges++;
+                // The grown request may now touch the next one; join them
+                int end = e->sector + e->size;
+                int npos = queue_lower_bound(q, end);
+                for (; npos < q->count && q->slots[q->sorted[npos]].sector == end; npos++) {
+                    int n = q->sorted[npos];
+                    if (n != s && q->slots[n].is_write == e->is_write &&
+                        e->size + q->slots[n].size <= cfg->max_merge_sectors) {
+                        queue_coalesce(q, s, n);
+                        stats->coalesced++;
+                        break;
+                    }
+                }
+                return;
+            }
+        }
+
+        // Front merge: a queued request starts exactly where this one ends
+        int end = r->sector + r->size;
+        for (int j = queue_lower_bound(q, end); j < q->count && q->slots[q->sorted[j]].sector == end; j++) {
+            int s = q->sorted[j];
+            QueuedRequest* e = &q->slots[s];
+            if (e->is_write == r->is_write && e->size + r->size <= cfg->max_merge_sectors) {
+                queue_remove_sorted(q, s);
+                e->sector = r->sector;
+                e->size += r->size;
+                q->member_next[member] = e->first_member;
+                e->first_member = member;
+                queue_insert_sorted(q, s);
+                stats->front_merges++;
+                // And the previous request may now end where this one starts
+                int ppos = queue_lower_bound(q, e->sector);
+                for (int k = ppos - 1; k >= 0 && k >= ppos - DISK_MERGE_LOOKBACK; k--) {
+                    int p = q->sorted[k];
+                    if (q->slots[p].is_write == e->is_write &&
+                        q->slots[p].sector + q->slots[p].size == e->sector &&
+                        q->slots[p].size + e->size <= cfg->max_merge_sectors) {
+                        queue_coalesce(q, p, s);
+                        stats->coalesced++;
+                        break;
+                    }
+                }
+                return;
+            }
+        }
+    }
+
+    int slot = q->free_slots[--q->num_free];
+    QueuedRequest* e = &q->slots[slot];
+    e->sector = r->sector;
+    e->size = r->size;
+    e->is_write = r->is_write;
+    e->deadline = deadline;
+    e->seq = q->next_seq++;
+    e->first_member = e->last_member = member;
+    queue_insert_sorted(q, slot);
+    fifo_append(q, slot);
+}
+
+// First queued request in direction 'dir' at or after 'sector', or -1.
+static int queue_next_in_dir(const DiskQueue* q, int dir, int sector) {
+    for (int j = queue_lower_bound(q, sector); j < q->count; j++) {
+        if (q->slots[q->sorted[j]].is_write == dir) return q->sorted[j];
+    }
+    return -1;
+}
+
+static int queue_pick(DiskQueue* q, const DiskQueueConfig* cfg, long now, DiskRunStats* stats) {
+    int rh = q->fifo_head[DISK_READ], wh = q->fifo_head[DISK_WRITE];
+    if (rh == -1 && wh == -1) return -1;
+
+    if (cfg->sched == DISK_SCHED_FCFS) {
+        if (rh == -1) return wh;
+        if (wh == -1) return rh;
+        return q->slots[rh].seq < q->slots[wh].seq ? rh : wh;
+    }
+
+    // Deadline: keep going through the current sorted batch if we can
+    if (q->batch_left > 0) {
+        int s = queue_next_in_dir(q, q->batch_dir, q->next_sector);
+        if (s != -1) {
+            q->batch_left--;
+            return s;
+        }
+    }
+
+    int dir;
+    if (rh != -1 && (wh == -1 || q->starved < cfg->writes_starved)) {
+        dir = DISK_READ;
+        if (wh != -1) q->starved++;
+    } else {
+        dir = DISK_WRITE;
+        q->starved = 0;
+    }
+
+    int head = q->fifo_head[dir];
+    int s;
+    if (q->slots[head].deadline <= now) {
+        s = head;
+        stats->expired++;
+    } else {
+        s = queue_next_in_dir(q, dir, q->next_sector);
+        if (s == -1) s = head; // Nothing further along; restart the sweep at the oldest request
+    }
+    q->batch_dir = dir;
+    q->batch_left = cfg->fifo_batch - 1;
+    return s;
+}
+
+typedef struct {
+    long arrival_time;
+    int index;
+} ArrivalOrder;
+
+static int compare_arrival(const void* a, const void* b) {
+    const ArrivalOrder* x = a;
+    const ArrivalOrder* y = b;
+    if (x->arrival_time != y->arrival_time) return x->arrival_time < y->arrival_time ? -1 : 1;
+    return x->index - y->index;
+}
+
+static int compare_long(const void* a, const void* b) {
+    long x = *(const long*)a, y = *(const long*)b;
+    return (x > y) - (x < y);
+}
+
+void disk_latency_summary(long lat[], int n, double* avg, double* p95, double* p99, long* max) {
+    *avg = *p95 = *p99 = 0;
+    *max = 0;
+    if (n <= 0) return;
+    qsort(lat, (size_t)n, sizeof(long), compare_long);
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += (double)lat[i];
+    *avg = sum / n;
+    *p95 = (double)lat[(int)((n - 1) * 0.95)];
+    *p99 = (double)lat[(int)((n - 1) * 0.99)];
+    *max = lat[n - 1];
+}
+
+void disk_replay(const DiskRequest trace[], int n, int initial_head_cyl,
+                 const DiskModel* model, const DiskQueueConfig* cfg, DiskRunStats* stats,
+                 long completion_out[], DiskDispatchFn on_dispatch, void* ctx) {
+    disk_replay_linked(trace, n, initial_head_cyl, model, cfg, stats, completion_out, on_dispatch, ctx, NULL);
+}
+
+void disk_replay_linked(const DiskRequest trace[], int n, int initial_head_cyl,
+                        const DiskModel* model, const DiskQueueConfig* cfg, DiskRunStats* stats,
+                        long completion_out[], DiskDispatchFn on_dispatch, void* ctx, const DiskLink* link) {
+    memset(stats, 0, sizeof(*stats));
+    stats->requests = n;
+    if (n <= 0) return;
+
+    DiskQueue q;
+    ArrivalOrder* order = malloc((size_t)n * sizeof(ArrivalOrder));
+    ArrivalOrder* released = malloc((size_t)n * sizeof(ArrivalOrder));
+    long* arrival = malloc((size_t)n * sizeof(long));
+    long* completion = malloc((size_t)n * sizeof(long));
+    if (!order || !released || !arrival || !completion || queue_init(&q, n) != 0) {
+        printf("Disk replay: out of memory for %d requests.\n", n);
+        free(order);
+        free(released);
+        free(arrival);
+        free(completion);
+        return;
+    }
+    // Held requests stay out of the arrival order until they are handed over
+    int num_static = 0;
+    for (int i = 0; i < n; i++) {
+        arrival[i] = trace[i].arrival_time;
+        completion[i] = -1;
+        if (link && link->held[i]) continue;
+        order[num_static].arrival_time = trace[i].arrival_time;
+        order[num_static].index = i;
+        num_static++;
+    }
+    qsort(order, (size_t)num_static, sizeof(ArrivalOrder), compare_arrival);
+    int num_released = 0, next_released = 0;
+
+    long total_sectors = (long)model->total_cylinders * model->sectors_per_cylinder;
+    long min_service = (long)model->rotational_latency + model->transfer_per_sector;
+    int head = initial_head_cyl;
+    q.next_sector = initial_head_cyl * model->sectors_per_cylinder; // First sorted batch sweeps up from the head
+    long now = 0;
+    int next = 0;
+    int busy = 0, inflight = -1;
+    long busy_until = 0;
+    int plugged = 0;
+    long plug_start = 0;
+
+    while (link || next < num_static || q.count > 0 || busy) {
+        int idx;
+        long at;
+        while (link && link->take(link->ctx, &idx, &at)) {
+            // Hand-overs come in roughly time order; keep the list sorted
+            int pos = num_released;
+            while (pos > next_released && released[pos - 1].arrival_time > at) {
+                released[pos] = released[pos - 1];
+                pos--;
+            }
+            released[pos].arrival_time = at;
+            released[pos].index = idx;
+            num_released++;
+            arrival[idx] = at;
+        }
+
+        long t = DISK_TIME_NEVER;
+        if (next < num_static && order[next].arrival_time < t) t = order[next].arrival_time;
+        if (next_released < num_released && released[next_released].arrival_time < t) {
+            t = released[next_released].arrival_time;
+        }
+        if (busy && busy_until < t) t = busy_until;
+        if (plugged && plug_start + cfg->plug_delay < t) t = plug_start + cfg->plug_delay;
+        if (!busy && !plugged && q.count > 0) t = now;
+        if (link) {
+            int finishing = busy && busy_until <= t;
+            long bound = busy ? busy_until : (t == DISK_TIME_NEVER ? t : t + min_service);
+            if (!link->wait(link->ctx, t, finishing, bound)) continue;
+            if (t == DISK_TIME_NEVER) break;
+        }
+        if (t > now) now = t;
+
+        if (busy && busy_until <= now) {
+            for (int m = inflight; m != -1; m = q.member_next[m]) {
+                completion[m] = busy_until;
+                metric_observe(&metric_disk_latency, busy_until - arrival[m]);
+                if (link) link->complete(link->ctx, m, busy_until);
+            }
+            busy = 0;
+            inflight = -1;
+            // Linked devices finish everything due at a time before any of
+            // them queues or dispatches at that time
+            if (link) continue;
+        }
+
+        while (1) {
+            int from_static = next < num_static && order[next].arrival_time <= now;
+            int from_released = next_released < num_released && released[next_released].arrival_time <= now;
+            if (!from_static && !from_released) break;
+            if (from_static && from_released) {
+                from_static = order[next].arrival_time <= released[next_released].arrival_time;
+            }
+            idx = from_static ? order[next++].index : released[next_released++].index;
+            const DiskRequest* r = &trace[idx];
+            if (r->size <= 0 || r->sector < 0 || r->sector + (long)r->size > total_sectors) {
+                stats->skipped++;
+                continue;
+            }
+            if (r->is_write) stats->writes++;
+            else stats->reads++;
+            metric_inc(&metric_disk_requests);
+            if (cfg->plug && !busy && !plugged && q.count == 0) {
+                plugged = 1;
+                plug_start = now;
+            }
+            queue_add(&q, cfg, r, idx, now, stats);
+        }
+
+        if (plugged && (q.count >= cfg->plug_max || now >= plug_start + cfg->plug_delay)) {
+            plugged = 0;
+            stats->unplugs++;
+        }
+
+        if (!busy && !plugged && q.count > 0) {
+            int s = queue_pick(&q, cfg, now, stats);
+            QueuedRequest e = q.slots[s];
+            queue_release(&q, s);
+            long service = disk_service_time(model, head, e.sector, e.size);
+            int cyl = e.sector / model->sectors_per_cylinder;
+            stats->head_movement += abs(cyl - head);
+            metric_inc(&metric_disk_dispatches);
+            metric_observe(&metric_disk_seek_distance, abs(cyl - head));
+            head = (e.sector + e.size - 1) / model->sectors_per_cylinder;
+            q.next_sector = e.sector + e.size;
+            stats->dispatched++;
+            stats->busy_time += service;
+            if (on_dispatch) on_dispatch(ctx, e.sector, e.size, e.is_write, now, service);
+            inflight = e.first_member;
+            busy = 1;
+            busy_until = now + service;
+        }
+    }
+    stats->makespan = now;
+    metric_add(&metric_disk_merges, stats->back_merges + stats->front_merges);
+
+    long* read_lat = malloc((size_t)(stats->reads + 1) * sizeof(long));
+    long* write_lat = malloc((size_t)(stats->writes + 1) * sizeof(long));
+    int nr = 0, nw = 0;
+    if (read_lat && write_lat) {
+        for (int i = 0; i < n; i++) {
+            if (completion[i] < 0) continue;
+            long lat = completion[i] - arrival[i];
+            if (trace[i].is_write) write_lat[nw++] = lat;
+            else read_lat[nr++] = lat;
+        }
+        disk_latency_summary(read_lat, nr, &stats->read_avg_latency, &stats->read_p95_latency,
+                        &stats->read_p99_latency, &stats->read_max_latency);
+        disk_latency_summary(write_lat, nw, &stats->write_avg_latency, &stats->write_p95_latency,
+                        &stats->write_p99_latency, &stats->write_max_latency);
+    }
+    if (completion_out) memcpy(completion_out, completion, (size_t)n * sizeof(long));
+
+    free(read_lat);
+    free(write_lat);
+    free(order);
+    free(released);
+    free(arrival);
+    free(completion);
+    queue_destroy(&q);
+}
+
+int disk_load_trace(const char* path, DiskRequest** out) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        printf("Cannot open trace file '%s'.\n", path);
+        return -1;
+    }
+    int count = 0, capacity = 64;
+    DiskRequest* reqs = malloc((size_t)capacity * sizeof(DiskRequest));
+    char line[256];
+    int line_no = 0;
+    while (reqs != NULL && fgets(line, sizeof(line), f) != NULL) {
+        line_no++;
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+
+        long arrival;
+        int sector, size;
+        char dir;
+        if (sscanf(p, "%ld %d %d %c", &arrival, &sector, &size, &dir) != 4 ||
+            (dir != 'R' && dir != 'r' && dir != 'W' && dir != 'w')) {
+            printf("Trace '%s' line %d: expected '<arrival> <sector> <size> <R|W>'.\n", path, line_no);
+            continue;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            DiskRequest* grown = realloc(reqs, (size_t)capacity * sizeof(DiskRequest));
+            if (grown == NULL) {
+                free(reqs);
+                reqs = NULL;
+                break;
+            }
+            reqs = grown;
+        }
+        reqs[count].arrival_time = arrival;
+        reqs[count].sector = sector;
+        reqs[count].size = size;
+        reqs[count].is_write = (dir == 'W' || dir == 'w');
+        count++;
+    }
+    fclose(f);
+    if (reqs == NULL) {
+        printf("Out of memory while loading trace '%s'.\n", path);
+        return -1;
+    }
+    *out = reqs;
+    return count;
+}
+
+static unsigned int disk_rand(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Mixed workload: a few sequential streams (which merge well), random reads,
+// and random writes, arriving in bursts separated by idle gaps.
+int disk_generate_trace(DiskRequest out[], int n, unsigned int seed, const DiskModel* model) {
+    unsigned int state = seed ? seed : 1;
+    int total_sectors = model->total_cylinders * model->sectors_per_cylinder;
+    if (total_sectors < DISK_MIN_TRACE_SECTORS) return -1;
+    // Random writes are 8..64 sectors, less on a disk too small for that
+    int max_extra = total_sectors - 16 < 56 ? total_sectors - 16 : 56;
+    int stream_pos[4];
+    for (int s = 0; s < 4; s++) stream_pos[s] = (int)(disk_rand(&state) % (unsigned)(total_sectors / 2));
+
+    long t = 0;
+    for (int i = 0; i < n; i++) {
+        if (i % 32 == 0) t += 100000 + disk_rand(&state) % 100000; // Idle gap, then a burst
+        else t += disk_rand(&state) % 400;
+
+        unsigned int kind = disk_rand(&state) % 10;
+        out[i].arrival_time = t;
+        if (kind < 5) {
+            int s = (int)(disk_rand(&state) % 4);
+            out[i].sector = stream_pos[s];
+            out[i].size = 8;
+            out[i].is_write = (s == 3);
+            stream_pos[s] += 8;
+            if (stream_pos[s] + 8 > total_sectors) stream_pos[s] = 0;
+        } else if (kind < 8) {
+            out[i].size = 8;
+            out[i].sector = (int)(disk_rand(&state) % (unsigned)(total_sectors - 8));
+            out[i].is_write = DISK_READ;
+        } else {
+            out[i].size = 8 + (int)(disk_rand(&state) % (unsigned)(max_extra + 1));
+            out[i].sector = (int)(disk_rand(&state) % (unsigned)(total_sectors - out[i].size));
+            out[i].is_write = DISK_WRITE;
+        }
+    }
+    return 0;
+}
+
+void disk_print_run_stats(const char* label, const DiskRunStats* s) {
+    printf("\n[%s]\n", label);
+    printf("  Requests: %d (reads %d, writes %d, skipped %d), dispatched: %d\n",
+           s->requests, s->reads, s->writes, s->skipped, s->dispatched);
+    printf("  Merges: %d back, %d front, %d coalesced | Unplugs: %d | Expired FIFO heads: %d\n",
+           s->back_merges, s->front_merges, s->coalesced, s->unplugs, s->expired);
+    printf("  Head movement: %ld cylinders | Busy: %ld us of %ld us\n",
+           s->head_movement, s->busy_time, s->makespan);
+    printf("  Read latency  (us): avg %.0f, p95 %.0f, p99 %.0f, max %ld\n",
+           s->read_avg_latency, s->read_p95_latency, s->read_p99_latency, s->read_max_latency);
+    printf("  Write latency (us): avg %.0f, p95 %.0f, p99 %.0f, max %ld\n",
+           s->write_avg_latency, s->write_p95_latency, s->write_p99_latency, s->write_max_latency);
+}
+
+static double percent_change(double before, double after) {
+    if (before == 0) return 0;
+    return (after - before) * 100.0 / before;
+}
+
+void simulate_disk_queue(const DiskRequest trace[], int n, int initial_head_cyl) {
+    printf("\n## Disk Request Queue Simulation ##\n");
+    DiskModel model;
+    disk_default_model(&model);
+    if (n <= 0) {
+        printf("No disk requests to process.\n");
+        return;
+    }
+    if (initial_head_cyl < 0 || initial_head_cyl >= model.total_cylinders) {
+        printf("Invalid initial head position %d. Must be between 0 and %d.\n", initial_head_cyl, model.total_cylinders - 1);
+        return;
+    }
+    printf("Cylinders: 0 to %d, %d sectors each | Initial Head Position: %d | Requests: %d\n",
+           model.total_cylinders - 1, model.sectors_per_cylinder, initial_head_cyl, n);
+
+    DiskQueueConfig base, merged, deadline;
+    disk_default_queue_config(&base, DISK_SCHED_FCFS);
+    base.merge = 0;
+    base.plug = 0;
+    disk_default_queue_config(&merged, DISK_SCHED_FCFS);
+    disk_default_queue_config(&deadline, DISK_SCHED_DEADLINE);
+
+    // The baselines are replayed only for comparison; the disk metrics
+    // describe the deadline run alone
+    DiskRunStats sb, sm, sd;
+    int saved_metrics = metrics_enabled;
+    metrics_enabled = 0;
+    disk_replay(trace, n, initial_head_cyl, &model, &base, &sb, NULL, NULL, NULL);
+    disk_replay(trace, n, initial_head_cyl, &model, &merged, &sm, NULL, NULL, NULL);
+    metrics_enabled = saved_metrics;
+    disk_replay(trace, n, initial_head_cyl, &model, &deadline, &sd, NULL, NULL, NULL);
+    disk_print_run_stats("FCFS, no merging", &sb);
+    disk_print_run_stats("FCFS + merge + plug", &sm);
+    disk_print_run_stats("Deadline + merge + plug", &sd);
+
+    printf("\nChange vs FCFS without merging:\n");
+    printf("%-26s %12s %12s %12s %12s\n", "Configuration", "Dispatched", "HeadMove", "Read p99", "Write p99");
+    printf("%-26s %+11.1f%% %+11.1f%% %+11.1f%% %+11.1f%%\n", "FCFS + merge + plug",
+           percent_change(sb.dispatched, sm.dispatched), percent_change(sb.head_movement, sm.head_movement),
+           percent_change(sb.read_p99_latency, sm.read_p99_latency), percent_change(sb.write_p99_latency, sm.write_p99_latency));
+    printf("%-26s %+11.1f%% %+11.1f%% %+11.1f%% %+11.1f%%\n", "Deadline + merge + plug",
+           percent_change(sb.dispatched, sd.dispatched), percent_change(sb.head_movement, sd.head_movement),
+           percent_change(sb.read_p99_latency, sd.read_p99_latency), percent_change(sb.write_p99_latency, sd.write_p99_latency));
+}
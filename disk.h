@@ -1,8 +1,115 @@
 #ifndef DISK_H
 #define DISK_H
 
-#define MAX_DISK_REQUESTS 50
+#define DISK_READ  0
+#define DISK_WRITE 1
+
+#define DISK_SCHED_FCFS     0 // Dispatch in arrival order (noop elevator)
+#define DISK_SCHED_DEADLINE 1 // Sorted batches with per-direction expiry
+
+#define DISK_TIME_NEVER 0x7fffffffffffffffL
+
+#define DISK_DEFAULT_CYLINDERS 200
+#define DISK_SECTORS_PER_CYLINDER 256
+#define DISK_MIN_TRACE_SECTORS 16 // Smallest disk a generated trace fits on
+
+// One I/O as it reaches the block layer. Times are in microseconds.
+typedef struct {
+    long arrival_time;
+    int sector;   // Starting sector (LBA)
+    int size;     // Length in sectors
+    int is_write; // DISK_READ or DISK_WRITE
+} DiskRequest;
+
+// Mechanical cost model used to turn dispatched requests into service time.
+typedef struct {
+    int total_cylinders;
+    int sectors_per_cylinder;
+    int seek_settle;         // Fixed cost of any non-zero seek
+    int seek_per_cylinder;   // Added per cylinder travelled
+    int rotational_latency;  // Average wait for the sector to come around
+    int transfer_per_sector;
+} DiskModel;
+
+typedef struct {
+    int sched;             // DISK_SCHED_FCFS or DISK_SCHED_DEADLINE
+    int merge;             // 1 to merge adjacent requests at the front and back
+    int plug;              // 1 to hold an idle queue back so a batch can build up
+    int plug_delay;        // How long a plugged queue waits before unplugging
+    int plug_max;          // Unplug early once this many requests are queued
+    int max_merge_sectors; // Largest request merging may produce
+    int read_expire;       // Deadline: reads older than this are served first
+    int write_expire;
+    int fifo_batch;        // Deadline: requests dispatched per sorted batch
+    int writes_starved;    // Deadline: read batches allowed before writes get one
+} DiskQueueConfig;
+
+typedef struct {
+    int requests;
+    int reads;
+    int writes;
+    int skipped;         // Out-of-range requests dropped on arrival
+    int dispatched;      // Requests actually sent to the head after merging
+    int back_merges;
+    int front_merges;
+    int coalesced;       // Queued requests joined together by a merge
+    int unplugs;
+    int expired;         // Deadline batches started because a FIFO head expired
+    long head_movement;  // In cylinders
+    long busy_time;
+    long makespan;       // Completion time of the last request
+    double read_avg_latency, read_p95_latency, read_p99_latency;
+    long read_max_latency;
+    double write_avg_latency, write_p95_latency, write_p99_latency;
+    long write_max_latency;
+} DiskRunStats;
+
+// Called once per dispatched (possibly merged) request, in dispatch order.
+typedef void (*DiskDispatchFn)(void* ctx, int sector, int size, int is_write, long start_time, long service_time);
+
+// Ties a replay to replays of other devices running on their own threads,
+// so a request can wait for work on another device (RAID read-modify-write).
+// Requests with held[i] set ignore their trace arrival time and arrive when
+// 'take' hands them over. Before every step the replay calls 'wait' with the
+// time of its next event (DISK_TIME_NEVER if it has none), whether that event
+// is the in-flight request finishing, and the earliest time it could still
+// complete a request. wait returns 1 once the step is safe to take, or 0 if
+// requests were handed over meanwhile and the step has to be planned again.
+typedef struct {
+    void* ctx;
+    const char* held;
+    int (*take)(void* ctx, int* index, long* arrival);
+    int (*wait)(void* ctx, long t, int finishing, long bound);
+    void (*complete)(void* ctx, int index, long t);
+} DiskLink;
 
 void simulate_fcfs_disk_scheduling(int requests[], int num_requests, int initial_head_pos, int total_cylinders);
 
+void disk_default_model(DiskModel* model);
+void disk_ssd_model(DiskModel* model);
+void disk_default_queue_config(DiskQueueConfig* cfg, int sched);
+long disk_service_time(const DiskModel* model, int from_cylinder, int sector, int size);
+
+// Replays a trace through the request queue. The trace does not have to be
+// sorted by arrival. completion_out (optional) receives each request's
+// completion time in trace order, or -1 for skipped requests.
+void disk_replay(const DiskRequest trace[], int n, int initial_head_cyl,
+                 const DiskModel* model, const DiskQueueConfig* cfg, DiskRunStats* stats,
+                 long completion_out[], DiskDispatchFn on_dispatch, void* ctx);
+// disk_replay for one member of a group of linked devices. Latencies of held
+// requests are measured from when they were handed over.
+void disk_replay_linked(const DiskRequest trace[], int n, int initial_head_cyl,
+                        const DiskModel* model, const DiskQueueConfig* cfg, DiskRunStats* stats,
+                        long completion_out[], DiskDispatchFn on_dispatch, void* ctx, const DiskLink* link);
+
+// Trace file lines are "<arrival_us> <sector> <size> <R|W>"; '#' starts a comment.
+// Returns the number of requests loaded into a malloc'd array, or -1 on error.
+int disk_load_trace(const char* path, DiskRequest** out);
+// Returns -1, generating nothing, for a disk of fewer than DISK_MIN_TRACE_SECTORS.
+int disk_generate_trace(DiskRequest out[], int n, unsigned int seed, const DiskModel* model);
+// Sorts lat[] in place and fills the summary; all outputs are 0 when n is 0.
+void disk_latency_summary(long lat[], int n, double* avg, double* p95, double* p99, long* max);
+void disk_print_run_stats(const char* label, const DiskRunStats* stats);
+void simulate_disk_queue(const DiskRequest trace[], int n, int initial_head_cyl);
+
 #endif // DISK_H
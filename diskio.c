@@ -0,0 +1,365 @@
+/**
+ * diskio.c
+ * Real-I/O backend for the disk simulator.
+ * The request stream a scheduler dispatched is issued as real block reads and
+ * writes against a host file or loop device, so the simulated service times
+ * can be checked against what the machine actually does. io_uring is driven
+ * through the raw system calls (no liburing needed); if the kernel refuses
+ * it, pread/pwrite is used instead.
+ */
+#define _GNU_SOURCE // O_DIRECT
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "diskio.h"
+#include "metrics.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define DISKIO_HAVE_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+#define DISKIO_ALIGN 4096
+#define DISKIO_FILL_CHUNK (1 << 20)
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Regular files are extended and filled with data so reads really hit the
+// device instead of returning holes. Block devices are used as they are.
+static int diskio_prepare(int fd, long total_sectors) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return -1;
+    if (!S_ISREG(st.st_mode)) return 0;
+    off_t want = (off_t)total_sectors * DISKIO_SECTOR_BYTES;
+    if (st.st_size >= want) return 0;
+
+    char* chunk;
+    if (posix_memalign((void**)&chunk, DISKIO_ALIGN, DISKIO_FILL_CHUNK) != 0) return -1;
+    memset(chunk, 0xA5, DISKIO_FILL_CHUNK);
+    off_t off = st.st_size - st.st_size % DISKIO_FILL_CHUNK;
+    int err = 0;
+    while (off < want && !err) {
+        if (pwrite(fd, chunk, DISKIO_FILL_CHUNK, off) != DISKIO_FILL_CHUNK) err = -1;
+        off += DISKIO_FILL_CHUNK;
+    }
+    free(chunk);
+    if (!err) fsync(fd);
+    return err;
+}
+
+static int diskio_sync_io(int fd, const DiskIOOp* op, char* buf) {
+    size_t len = (size_t)op->size * DISKIO_SECTOR_BYTES;
+    off_t off = (off_t)op->sector * DISKIO_SECTOR_BYTES;
+    ssize_t r = op->is_write ? pwrite(fd, buf, len, off) : pread(fd, buf, len, off);
+    return r == (ssize_t)len ? 0 : -1;
+}
+
+static int diskio_run_pread(int fd, const DiskIOOp ops[], int n, char* buf, long lat[], DiskIOResult* res) {
+    for (int i = 0; i < n; i++) {
+        double t0 = now_us();
+        if (diskio_sync_io(fd, &ops[i], buf) != 0) res->errors++;
+        lat[i] = (long)(now_us() - t0);
+    }
+    return 0;
+}
+
+#ifdef DISKIO_HAVE_URING
+typedef struct {
+    int fd;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    void* sq_ptr;
+    void* cq_ptr;
+    size_t sq_len, cq_len, sqes_len;
+} Uring;
+
+static int uring_init(Uring* u, unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    memset(u, 0, sizeof(*u));
+    u->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+    if (u->fd < 0) return -1;
+
+    u->sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    u->cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (u->cq_len > u->sq_len) u->sq_len = u->cq_len;
+        u->cq_len = u->sq_len;
+    }
+    u->sq_ptr = mmap(NULL, u->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQ_RING);
+    if (u->sq_ptr == MAP_FAILED) goto fail;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        u->cq_ptr = u->sq_ptr;
+    } else {
+        u->cq_ptr = mmap(NULL, u->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_CQ_RING);
+        if (u->cq_ptr == MAP_FAILED) goto fail;
+    }
+    u->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes = mmap(NULL, u->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED) goto fail;
+
+    char* sq = u->sq_ptr;
+    char* cq = u->cq_ptr;
+    u->sq_head = (unsigned*)(sq + p.sq_off.head);
+    u->sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    u->sq_mask = (unsigned*)(sq + p.sq_off.ring_mask);
+    u->sq_array = (unsigned*)(sq + p.sq_off.array);
+    u->cq_head = (unsigned*)(cq + p.cq_off.head);
+    u->cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    u->cq_mask = (unsigned*)(cq + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+    return 0;
+
+fail:
+    if (u->sq_ptr && u->sq_ptr != MAP_FAILED) munmap(u->sq_ptr, u->sq_len);
+    if (u->cq_ptr && u->cq_ptr != MAP_FAILED && u->cq_ptr != u->sq_ptr) munmap(u->cq_ptr, u->cq_len);
+    close(u->fd);
+    return -1;
+}
+
+static void uring_destroy(Uring* u) {
+    munmap(u->sqes, u->sqes_len);
+    if (u->cq_ptr != u->sq_ptr) munmap(u->cq_ptr, u->cq_len);
+    munmap(u->sq_ptr, u->sq_len);
+    close(u->fd);
+}
+
+// Keeps up to 'depth' requests in flight, submitting in dispatch order.
+// Latency is measured per request from submission to completion.
+static int diskio_run_uring(int fd, const DiskIOOp ops[], int n, int depth, char* bufs, size_t buf_size,
+                            long lat[], DiskIOResult* res) {
+    Uring u;
+    if (uring_init(&u, (unsigned)depth) != 0) return -1;
+
+    int free_slots[DISKIO_MAX_QUEUE_DEPTH];
+    int slot_op[DISKIO_MAX_QUEUE_DEPTH];
+    double slot_start[DISKIO_MAX_QUEUE_DEPTH];
+    for (int s = 0; s < depth; s++) free_slots[s] = s;
+    int num_free = depth;
+    int next = 0, done = 0;
+    unsigned first_head = *u.sq_head;
+
+    while (done < n) {
+        unsigned tail = *u.sq_tail;
+        while (num_free > 0 && next < n) {
+            int slot = free_slots[--num_free];
+            const DiskIOOp* op = &ops[next];
+            unsigned idx = tail & *u.sq_mask;
+            struct io_uring_sqe* sqe = &u.sqes[idx];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = op->is_write ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->addr = (unsigned long)(bufs + (size_t)slot * buf_size);
+            sqe->len = (unsigned)op->size * DISKIO_SECTOR_BYTES;
+            sqe->off = (unsigned long long)op->sector * DISKIO_SECTOR_BYTES;
+            sqe->user_data = (unsigned long long)slot;
+            u.sq_array[idx] = idx;
+            slot_op[slot] = next;
+            slot_start[slot] = now_us();
+            tail++;
+            next++;
+        }
+        __atomic_store_n(u.sq_tail, tail, __ATOMIC_RELEASE);
+
+        // Entries the kernel has not consumed yet, including any left behind by
+        // a short or interrupted submit; everything else issued is in flight.
+        unsigned pending = tail - __atomic_load_n(u.sq_head, __ATOMIC_ACQUIRE);
+        int in_flight = next - done - (int)pending;
+        // Only block for a completion when one is already owed, so a submit
+        // that makes no progress cannot leave us waiting forever.
+        unsigned min_complete = in_flight > 0 ? 1 : 0;
+        unsigned flags = in_flight > 0 ? IORING_ENTER_GETEVENTS : 0;
+        int ret = (int)syscall(__NR_io_uring_enter, u.fd, pending, min_complete, flags, NULL, 0);
+        if (ret < 0 && errno != EINTR) {
+            int err = errno;
+            // Nothing reached the kernel yet: the caller can still fall back
+            int consumed = __atomic_load_n(u.sq_head, __ATOMIC_ACQUIRE) != first_head;
+            uring_destroy(&u);
+            errno = err;
+            return done == 0 && !consumed ? -1 : -2;
+        }
+
+        unsigned head = *u.cq_head;
+        while (head != __atomic_load_n(u.cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe* cqe = &u.cqes[head & *u.cq_mask];
+            int slot = (int)cqe->user_data;
+            int i = slot_op[slot];
+            lat[i] = (long)(now_us() - slot_start[slot]);
+            if (cqe->res != ops[i].size * DISKIO_SECTOR_BYTES) res->errors++;
+            free_slots[num_free++] = slot;
+            done++;
+            head++;
+        }
+        __atomic_store_n(u.cq_head, head, __ATOMIC_RELEASE);
+    }
+    uring_destroy(&u);
+    return 0;
+}
+#endif
+
+int diskio_run(const DiskIOConfig* cfg, const DiskIOOp ops[], int n, long total_sectors, DiskIOResult* res) {
+    memset(res, 0, sizeof(*res));
+    res->ios = n;
+    int depth = cfg->queue_depth;
+    if (depth < 1) depth = 1;
+    if (depth > DISKIO_MAX_QUEUE_DEPTH) depth = DISKIO_MAX_QUEUE_DEPTH;
+
+    int fd = -1;
+    res->direct_used = 0;
+    if (cfg->direct) {
+        fd = open(cfg->path, O_RDWR | O_CREAT | O_DIRECT, 0644);
+        if (fd >= 0) res->direct_used = 1;
+        else printf("O_DIRECT not supported for '%s' (%s); using buffered I/O.\n", cfg->path, strerror(errno));
+    }
+    if (fd < 0) fd = open(cfg->path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        printf("Cannot open '%s': %s\n", cfg->path, strerror(errno));
+        return -1;
+    }
+    if (diskio_prepare(fd, total_sectors) != 0) {
+        printf("Cannot prepare '%s' for %ld sectors: %s\n", cfg->path, total_sectors, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    int max_sectors = 1;
+    for (int i = 0; i < n; i++) {
+        if (ops[i].size > max_sectors) max_sectors = ops[i].size;
+        res->bytes += (long)ops[i].size * DISKIO_SECTOR_BYTES;
+    }
+    size_t buf_size = ((size_t)max_sectors * DISKIO_SECTOR_BYTES + DISKIO_ALIGN - 1) / DISKIO_ALIGN * DISKIO_ALIGN;
+    char* bufs = NULL;
+    long* lat = malloc((size_t)(n > 0 ? n : 1) * sizeof(long));
+    if (lat == NULL || posix_memalign((void**)&bufs, DISKIO_ALIGN, buf_size * (size_t)depth) != 0) {
+        printf("Out of memory for %d I/O buffers.\n", depth);
+        free(lat);
+        close(fd);
+        return -1;
+    }
+    memset(bufs, 0x5A, buf_size * (size_t)depth);
+
+    double t0 = now_us();
+    int rc = -1;
+    res->backend_used = DISKIO_BACKEND_PREAD;
+#ifdef DISKIO_HAVE_URING
+    if (cfg->backend == DISKIO_BACKEND_URING) {
+        rc = diskio_run_uring(fd, ops, n, depth, bufs, buf_size, lat, res);
+        if (rc == 0) res->backend_used = DISKIO_BACKEND_URING;
+        else if (rc == -1) printf("io_uring unavailable (%s); falling back to pread/pwrite.\n", strerror(errno));
+        else printf("io_uring failed mid-run (%s).\n", strerror(errno));
+    }
+#else
+    if (cfg->backend == DISKIO_BACKEND_URING) printf("Built without io_uring; using pread/pwrite.\n");
+#endif
+    if (rc == -1) {
+        t0 = now_us();
+        res->errors = 0;
+        rc = diskio_run_pread(fd, ops, n, bufs, lat, res);
+    }
+    res->wall_us = now_us() - t0;
+
+    double avg, p95, p99;
+    long max;
+    disk_latency_summary(lat, n, &avg, &p95, &p99, &max);
+    res->avg_latency_us = avg;
+    res->p95_latency_us = p95;
+    res->p99_latency_us = p99;
+    res->max_latency_us = max;
+
+    free(bufs);
+    free(lat);
+    close(fd);
+    return rc == 0 ? 0 : -1;
+}
+
+typedef struct {
+    DiskIOOp* ops;
+    int count;
+    int capacity;
+} OpLog;
+
+static void collect_dispatch(void* ctx, int sector, int size, int is_write, long start_time, long service_time) {
+    OpLog* log = ctx;
+    (void)start_time;
+    if (log->count == log->capacity) return;
+    log->ops[log->count].sector = sector;
+    log->ops[log->count].size = size;
+    log->ops[log->count].is_write = is_write;
+    log->ops[log->count].sim_service = service_time;
+    log->count++;
+}
+
+void simulate_disk_real_io(const DiskIOConfig* cfg, const DiskRequest trace[], int n, int initial_head_cyl) {
+    printf("\n## Disk Simulation vs Real I/O ##\n");
+    if (n <= 0) {
+        printf("No disk requests to process.\n");
+        return;
+    }
+    DiskModel model;
+    disk_default_model(&model);
+    long total_sectors = (long)model.total_cylinders * model.sectors_per_cylinder;
+
+    const char* labels[3] = {"FCFS, no merging", "FCFS + merge + plug", "Deadline + merge + plug"};
+    DiskQueueConfig configs[3];
+    disk_default_queue_config(&configs[0], DISK_SCHED_FCFS);
+    configs[0].merge = 0;
+    configs[0].plug = 0;
+    disk_default_queue_config(&configs[1], DISK_SCHED_FCFS);
+    disk_default_queue_config(&configs[2], DISK_SCHED_DEADLINE);
+
+    OpLog log;
+    log.capacity = n;
+    log.ops = malloc((size_t)n * sizeof(DiskIOOp));
+    if (log.ops == NULL) {
+        printf("Out of memory for %d requests.\n", n);
+        return;
+    }
+
+    printf("Target: %s | Backend: %s | Queue depth: %d | %s\n", cfg->path,
+           cfg->backend == DISKIO_BACKEND_URING ? "io_uring" : "pread/pwrite",
+           cfg->queue_depth, cfg->direct ? "O_DIRECT" : "buffered");
+    printf("Streams are issued back to back in dispatch order; arrival gaps are not replayed.\n");
+    printf("\n%-24s %6s %11s %11s %11s %11s %11s %9s\n", "Scheduler", "IOs", "Sim avg", "Real avg",
+           "Real p95", "Real p99", "Sim total", "Real tot");
+    printf("%-24s %6s %11s %11s %11s %11s %11s %9s\n", "", "", "(us)", "(us)", "(us)", "(us)", "(ms)", "(ms)");
+    int saved_metrics = metrics_enabled;
+    for (int c = 0; c < 3; c++) {
+        DiskRunStats stats;
+        log.count = 0;
+        // As in disk_queue, only the deadline replay feeds the disk metrics
+        metrics_enabled = (c == 2) ? saved_metrics : 0;
+        disk_replay(trace, n, initial_head_cyl, &model, &configs[c], &stats, NULL, collect_dispatch, &log);
+        metrics_enabled = saved_metrics;
+        double sim_total = 0;
+        for (int i = 0; i < log.count; i++) sim_total += log.ops[i].sim_service;
+
+        DiskIOResult res;
+        if (diskio_run(cfg, log.ops, log.count, total_sectors, &res) != 0) break;
+        printf("%-24s %6d %11.0f %11.0f %11.0f %11.0f %11.1f %9.1f%s%s\n", labels[c], log.count,
+               log.count > 0 ? sim_total / log.count : 0.0, res.avg_latency_us, res.p95_latency_us,
+               res.p99_latency_us, sim_total / 1000, res.wall_us / 1000,
+               res.backend_used == DISKIO_BACKEND_URING ? "" : " [pread]",
+               res.errors ? " [errors]" : "");
+    }
+    free(log.ops);
+}
@@ -0,0 +1,45 @@
+#ifndef DISKIO_H
+#define DISKIO_H
+
+#include "disk.h"
+
+#define DISKIO_BACKEND_URING 0 // io_uring, falls back to pread/pwrite when unavailable
+#define DISKIO_BACKEND_PREAD 1 // Synchronous pread/pwrite, one request at a time
+
+#define DISKIO_SECTOR_BYTES 512
+#define DISKIO_MAX_QUEUE_DEPTH 256
+
+typedef struct {
+    const char* path;  // Regular file (created/filled as needed) or block device
+    int backend;
+    int queue_depth;   // Requests kept in flight by the io_uring backend
+    int direct;        // 1 to open with O_DIRECT and bypass the page cache
+} DiskIOConfig;
+
+// One request as the scheduler dispatched it, with its simulated cost.
+typedef struct {
+    int sector;
+    int size;
+    int is_write;
+    long sim_service;
+} DiskIOOp;
+
+typedef struct {
+    int backend_used;  // May differ from the requested backend after a fallback
+    int direct_used;
+    int ios;
+    int errors;
+    long bytes;
+    double wall_us;    // Time to drain the whole stream
+    double avg_latency_us, p95_latency_us, p99_latency_us;
+    long max_latency_us;
+} DiskIOResult;
+
+// Issues ops[] in order against the configured target. Returns 0 on success.
+int diskio_run(const DiskIOConfig* cfg, const DiskIOOp ops[], int n, long total_sectors, DiskIOResult* result);
+
+// Replays the trace through each scheduling configuration, then issues each
+// resulting dispatch stream as real I/O and prints simulated vs measured latency.
+void simulate_disk_real_io(const DiskIOConfig* cfg, const DiskRequest trace[], int n, int initial_head_cyl);
+
+#endif // DISKIO_H
@@ -0,0 +1,85 @@
+/**
+ * event.c
+ * Discrete-event simulation core. Subsystems post timed callbacks and the
+ * engine fires them in (time, post order) order, advancing simulated time.
+ */
+#include <stdlib.h>
+#include "event.h"
+
+#define EVENT_INITIAL_CAPACITY 1024
+
+EventEngine sim_engine;
+
+void event_engine_init(EventEngine* e) {
+    e->heap = NULL;
+    e->count = 0;
+    e->capacity = 0;
+    e->now = 0;
+    e->next_seq = 0;
+    e->processed = 0;
+}
+
+void event_engine_destroy(EventEngine* e) {
+    free(e->heap);
+    event_engine_init(e);
+}
+
+static int event_before(const Event* a, const Event* b) {
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+int event_post(EventEngine* e, long delay, EventFn fn, void* ctx, long arg) {
+    if (e->count == e->capacity) {
+        int capacity = e->capacity ? e->capacity * 2 : EVENT_INITIAL_CAPACITY;
+        Event* heap = realloc(e->heap, (size_t)capacity * sizeof(Event));
+        if (heap == NULL) return -1;
+        e->heap = heap;
+        e->capacity = capacity;
+    }
+    Event ev;
+    ev.time = e->now + (delay > 0 ? delay : 0);
+    ev.seq = e->next_seq++;
+    ev.fn = fn;
+    ev.ctx = ctx;
+    ev.arg = arg;
+
+    // Sift up
+    int i = e->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&ev, &e->heap[parent])) break;
+        e->heap[i] = e->heap[parent];
+        i = parent;
+    }
+    e->heap[i] = ev;
+    return 0;
+}
+
+static Event event_pop(EventEngine* e) {
+    Event top = e->heap[0];
+    Event last = e->heap[--e->count];
+    // Sift the last element down from the root
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= e->count) break;
+        if (child + 1 < e->count && event_before(&e->heap[child + 1], &e->heap[child])) child++;
+        if (!event_before(&e->heap[child], &last)) break;
+        e->heap[i] = e->heap[child];
+        i = child;
+    }
+    if (e->count > 0) e->heap[i] = last;
+    return top;
+}
+
+long event_run(EventEngine* e, long until) {
+    long fired = 0;
+    while (e->count > 0 && (until < 0 || e->heap[0].time <= until)) {
+        Event ev = event_pop(e);
+        e->now = ev.time;
+        ev.fn(ev.ctx, ev.arg);
+        fired++;
+    }
+    e->processed += fired;
+    return fired;
+}
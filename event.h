@@ -0,0 +1,36 @@
+#ifndef EVENT_H
+#define EVENT_H
+
+// Discrete-event engine: a binary min-heap of timed callbacks. Events at the
+// same time fire in the order they were posted. Times are in microseconds.
+typedef void (*EventFn)(void* ctx, long arg);
+
+typedef struct {
+    long time;
+    unsigned long seq;
+    EventFn fn;
+    void* ctx;
+    long arg;
+} Event;
+
+typedef struct {
+    Event* heap;
+    int count;
+    int capacity;
+    long now;
+    unsigned long next_seq;
+    long processed;
+} EventEngine;
+
+// The engine the shell's simulations share.
+extern EventEngine sim_engine;
+
+void event_engine_init(EventEngine* e);
+void event_engine_destroy(EventEngine* e);
+// Schedules fn(ctx, arg) 'delay' after the current time. Returns -1 when out of memory.
+int event_post(EventEngine* e, long delay, EventFn fn, void* ctx, long arg);
+// Fires events in time order until none are left or the next is after 'until'
+// (pass -1 for no limit). Returns the number of events fired.
+long event_run(EventEngine* e, long until);
+
+#endif // EVENT_H
@@ -6,74 +6,81 @@
 #include <stdio.h>
 #include <string.h>
 #include "filesystem.h"
+#include "simlog.h"
+#include "metrics.h"
 
-File file_system[MAX_FILES];
-int num_active_files = 0;
+static FileSystemState shell_filesystem;
+__thread FileSystemState* fs_state = &shell_filesystem;
 
 void init_filesystem() {
-    printf("\n-- Basic File System Simulation ##\n");
+    FileSystemState* fs = fs_state;
+    SIM_LOG("\n-- Basic File System Simulation ##\n");
     for (int i = 0; i < MAX_FILES; i++) {
-        file_system[i].allocated = 0;
-        strcpy(file_system[i].name, "");
-        file_system[i].size = 0;
+        fs->files[i].allocated = 0;
+        strcpy(fs->files[i].name, "");
+        fs->files[i].size = 0;
     }
-    num_active_files = 0;
-    printf("File system initialized. Max files: %d\n", MAX_FILES);
+    fs->num_active_files = 0;
+    metric_set(&metric_fs_files, 0);
+    SIM_LOG("File system initialized. Max files: %d\n", MAX_FILES);
 }
 
 void create_file_sim(const char* filename, int size) {
+    FileSystemState* fs = fs_state;
     if (strlen(filename) >= MAX_FILENAME_LEN) {
-        printf("Filename '%s' is too long. Max length is %d.\n", filename, MAX_FILENAME_LEN -1);
+        SIM_LOG("Filename '%s' is too long. Max length is %d.\n", filename, MAX_FILENAME_LEN -1);
         return;
     }
-    if (num_active_files >= MAX_FILES) {
-        printf("File system full. Cannot create '%s'.\n", filename);
+    if (fs->num_active_files >= MAX_FILES) {
+        SIM_LOG("File system full. Cannot create '%s'.\n", filename);
         return;
     }
     // Check if file already exists
-    for (int i = 0; i < MAX_FILES; i++) {
-        if (file_system[i].allocated && strcmp(file_system[i].name, filename) == 0) {
-            printf("File '%s' already exists.\n", filename);
-            return;
-        }
+    if (find_file_sim(filename) != -1) {
+        SIM_LOG("File '%s' already exists.\n", filename);
+        return;
     }
 
     for (int i = 0; i < MAX_FILES; i++) {
-        if (!file_system[i].allocated) {
-            //strcpy(file_system[i].name, filename);
+        if (!fs->files[i].allocated) {
+            //strcpy(fs->files[i].name, filename);
             // Using strncpy prevents buffer overflows
-            strncpy(file_system[i].name, filename, MAX_FILENAME_LEN - 1);
-            file_system[i].name[MAX_FILENAME_LEN - 1] = '\0'; // Manual null-termination for safety
-            file_system[i].size = size;
-            file_system[i].allocated = 1;
-            num_active_files++;
-            printf("File '%s' (size %d) created.\n", filename, size);
+            strncpy(fs->files[i].name, filename, MAX_FILENAME_LEN - 1);
+            fs->files[i].name[MAX_FILENAME_LEN - 1] = '\0'; // Manual null-termination for safety
+            fs->files[i].size = size;
+            fs->files[i].allocated = 1;
+            fs->num_active_files++;
+            metric_inc(&metric_fs_creates);
+            metric_set(&metric_fs_files, fs->num_active_files);
+            SIM_LOG("File '%s' (size %d) created.\n", filename, size);
             return;
         }
     }
 }
 
 void delete_file_sim(const char* filename) {
-    for (int i = 0; i < MAX_FILES; i++) {
-        if (file_system[i].allocated && strcmp(file_system[i].name, filename) == 0) {
-            file_system[i].allocated = 0;
-            memset(file_system[i].name, 0, MAX_FILENAME_LEN); // Wipe the name
-            file_system[i].size = 0;                          // Reset the size
-            num_active_files--;
-            printf("File '%s' deleted successfully.\n", filename);
+    FileSystemState* fs = fs_state;
+    int i = find_file_sim(filename);
+    if (i == -1) {
+        SIM_LOG("File '%s' not found for deletion.\n", filename);
         return;
-}
-        
     }
-    printf("File '%s' not found for deletion.\n", filename);
+    fs->files[i].allocated = 0;
+    memset(fs->files[i].name, 0, MAX_FILENAME_LEN); // Wipe the name
+    fs->files[i].size = 0;                          // Reset the size
+    fs->num_active_files--;
+    metric_inc(&metric_fs_deletes);
+    metric_set(&metric_fs_files, fs->num_active_files);
+    SIM_LOG("File '%s' deleted successfully.\n", filename);
 }
 
 void list_files_sim() {
-    printf("\n--- Files in System (%d active) ---\n", num_active_files);
+    FileSystemState* fs = fs_state;
+    printf("\n--- Files in System (%d active) ---\n", fs->num_active_files);
     int found = 0;
     for (int i = 0; i < MAX_FILES; i++) {
-        if (file_system[i].allocated) {
-            printf("- Name: %s, Size: %d\n", file_system[i].name, file_system[i].size);
+        if (fs->files[i].allocated) {
+            printf("- Name: %s, Size: %d\n", fs->files[i].name, fs->files[i].size);
             found = 1;
         }
     }
@@ -81,3 +88,16 @@ void list_files_sim() {
         printf("No files in the system.\n");
     }
 }
+
+int find_file_sim(const char* filename) {
+    FileSystemState* fs = fs_state;
+    metric_inc(&metric_fs_lookups);
+    for (int i = 0; i < MAX_FILES; i++) {
+        if (fs->files[i].allocated && strcmp(fs->files[i].name, filename) == 0) {
+            metric_observe(&metric_fs_lookup_length, i + 1);
+            return i;
+        }
+    }
+    metric_observe(&metric_fs_lookup_length, MAX_FILES);
+    return -1;
+}
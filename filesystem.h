@@ -10,9 +10,19 @@ typedef struct {
     int allocated; // 1 if exists, 0 if deleted/free slot
 } File;
 
+// One simulated file system. Like memory.c's mem_state, fs_state starts out
+// at the shell's instance in every thread.
+typedef struct {
+    File files[MAX_FILES];
+    int num_active_files;
+} FileSystemState;
+
+extern __thread FileSystemState* fs_state;
+
 void init_filesystem();
 void create_file_sim(const char* filename, int size);
 void delete_file_sim(const char* filename);
 void list_files_sim();
+int find_file_sim(const char* filename); // Index in fs_state->files, or -1
 
 #endif // FILESYSTEM_H
@@ -1,15 +1,22 @@
 #include <stdio.h>
 #include <string.h> 
 #include <stdlib.h> 
+#include <time.h>
+#include <unistd.h>
 
 #include "scheduler.h"
 #include "memory.h"
 #include "filesystem.h"
 #include "disk.h"
-
-#define MAX_MEM_PROCESSES_MAIN 5
-ProcessMemoryInfo mem_proc_infos[MAX_MEM_PROCESSES_MAIN];
-int current_mem_processes_count = 0;
+#include "raid.h"
+#include "diskio.h"
+#include "metrics.h"
+#include "proctable.h"
+#include "procsim.h"
+#include "simlog.h"
+#include "sweep.h"
+#include "workload.h"
+#include "threadpool.h"
 
 int memory_initialized_flag = 0;
 int fs_initialized_flag = 0;
@@ -18,384 +25,613 @@ typedef struct {
     char name[50];
     int pages_needed;
     char file_to_access[50];
+    long cpu_time; // Compute time in microseconds
 } ProgramProfile;
 
 #define NUM_KNOWN_PROGRAMS 3
 ProgramProfile known_programs[NUM_KNOWN_PROGRAMS] = {
-    {"editor", 4, "mydoc.txt"},
-    {"compiler", 6, "source.c"},
-    {"player", 2, "song.mp3"}
+    {"editor", 4, "mydoc.txt", 20000},
+    {"compiler", 6, "source.c", 80000},
+    {"player", 2, "song.mp3", 40000}
 };
 
 
-#ifndef FILESYSTEM_C_INCLUDED // Guard to prevent redefinition if filesystem.c includes this main.h in a complex setup
-extern File file_system[MAX_FILES]; // Assuming MAX_FILES is defined in filesystem.h
-#endif
-
-
 void clear_input_buffer() {
     int c;
     while ((c = getchar()) != '\n' && c != EOF);
 }
 
-// Function to tokenize input string
-#define MAX_ARGS 10
-#define MAX_CMD_LEN 100
-int parse_command(char* input, char** command, char* args[]) {
-    char* token;
+// Splits the line in place on whitespace; no copies are made. argv is grown
+// when a line has more words than it can hold and is reused for later lines.
+#define INITIAL_ARGS 16
+int parse_command(char* input, char*** argv, int* argv_cap) {
     int argc = 0;
+    char* p = input;
+    while (1) {
+        while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+        if (*p == '\0') break;
+        if (argc + 1 >= *argv_cap) {
+            int cap = *argv_cap * 2;
+            char** grown = realloc(*argv, (size_t)cap * sizeof(char*));
+            if (grown == NULL) break;
+            *argv = grown;
+            *argv_cap = cap;
+        }
+        (*argv)[argc++] = p;
+        while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') p++;
+        if (*p != '\0') *p++ = '\0';
+    }
+    (*argv)[argc] = NULL;
+    return argc;
+}
+
+// Command handlers get the command name in argv[0]. Returning SHELL_EXIT ends the shell.
+#define SHELL_EXIT 1
+typedef int (*CommandFn)(int argc, char* argv[]);
 
-    char input_copy[MAX_CMD_LEN];
-    strncpy(input_copy, input, MAX_CMD_LEN -1);
-    input_copy[MAX_CMD_LEN -1] = '\0';
+typedef struct {
+    const char* name;
+    CommandFn run;
+    const char* help;
+} Command;
 
-    token = strtok(input_copy, " \t\n"); 
-    if (token == NULL) {
-        return 0; 
+static int cmd_help(int argc, char* argv[]);
+
+static int cmd_exit(int argc, char* argv[]) {
+    printf("Exiting MyOS shell.\n");
+    return SHELL_EXIT;
+}
+
+// Fills 'prog' from the known profiles, or the defaults for unknown programs.
+static int lookup_program(const char* name, SimProgram* prog) {
+    strncpy(prog->name, name, sizeof(prog->name) - 1);
+    prog->name[sizeof(prog->name) - 1] = '\0';
+    for (int i = 0; i < NUM_KNOWN_PROGRAMS; i++) {
+        if (strcmp(known_programs[i].name, name) == 0) {
+            prog->pages = known_programs[i].pages_needed;
+            strcpy(prog->file, known_programs[i].file_to_access);
+            prog->cpu_time = known_programs[i].cpu_time;
+            return 1;
+        }
     }
-    *command = strdup(token); 
+    prog->pages = 3;
+    strcpy(prog->file, "default_data.txt");
+    prog->cpu_time = 30000;
+    return 0;
+}
 
-    while ((token = strtok(NULL, " \t\n")) != NULL && argc < MAX_ARGS) {
-        args[argc++] = strdup(token);
+static void ensure_sim_ready(void) {
+    if (!memory_initialized_flag) {
+        init_memory_management();
+        memory_initialized_flag = 1;
+        proctable_destroy(&process_table);
+    }
+    if (!fs_initialized_flag) {
+        init_filesystem();
+        fs_initialized_flag = 1;
     }
-    return argc + 1; 
 }
 
-void free_parsed_command(char* command, char* args[], int arg_count) {
-    if (command) free(command);
-    // arg_count includes the command itself. So if arg_count is 1, args array is empty.
-    // If arg_count is 2, args[0] is valid. Loop goes from i=0 to (arg_count-1 -1).
-    for (int i = 0; i < arg_count - 1; ++i) { 
-        if (args[i]) free(args[i]);
+// Runs the spawned processes on sim_engine to completion and prints the summary.
+static void run_simulation(SimSystem* sys) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    long events = procsim_run(sys);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    procsim_report(sys, events, (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+    procsim_destroy(sys);
+}
+
+// exec_process and run_programs: each named program becomes a process; they
+// arrive together and share the CPU, the pager and the disk.
+static int cmd_exec_process(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s <program_name>%s\n", argv[0], strcmp(argv[0], "run_programs") == 0 ? " [program_name...]" : "");
+        printf("Known programs: editor, compiler, player. Others use defaults.\n");
+        return 0;
+    }
+    int count = strcmp(argv[0], "exec_process") == 0 ? 2 : argc;
+    ensure_sim_ready();
+
+    SimConfig cfg;
+    procsim_default_config(&cfg);
+    cfg.trace = 1;
+    SimSystem sys;
+    procsim_init(&sys, &sim_engine, &process_table, &cfg);
+    for (int i = 1; i < count; i++) {
+        SimProgram prog;
+        if (lookup_program(argv[i], &prog)) {
+            printf("[OS_SIM_INFO] Using profile for known program: '%s'\n", argv[i]);
+        } else {
+            printf("[OS_SIM_INFO] Program '%s' not in known profiles. Using default settings (Pages: %d, File: %s).\n",
+                   argv[i], prog.pages, prog.file);
+        }
+        printf("--- Simulating Lifecycle for Program: %s ---\n", argv[i]);
+        if (procsim_spawn(&sys, &prog, 0) != 0) {
+            printf("[OS_SIM_ERROR] Out of memory creating the process.\n");
+        }
     }
+    run_simulation(&sys);
+    return 0;
 }
 
-int main() {
-    char input_line[MAX_CMD_LEN];
-    char* command = NULL;
-    char* args[MAX_ARGS];
-    int arg_count;
+// sim_load <n> [cores] [seed] [gap]: n random programs arriving on average
+// every 'gap' microseconds, untraced.
+static int cmd_sim_load(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: sim_load <num_processes> [cores] [seed] [mean_gap_us]\n");
+        return 0;
+    }
+    int n = atoi(argv[1]);
+    if (n <= 0) {
+        printf("Error: num_processes must be positive.\n");
+        return 0;
+    }
+    int cores = argc > 2 ? atoi(argv[2]) : 1;
+    unsigned int seed = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : 1;
+    long gap = argc > 4 ? atol(argv[4]) : 200000;
+    if (gap < 1) gap = 1;
+    ensure_sim_ready();
+
+    SimConfig cfg;
+    procsim_default_config(&cfg);
+    cfg.cores = cores;
+    SimSystem sys;
+    procsim_init(&sys, &sim_engine, &process_table, &cfg);
+
+    int saved_verbose = sim_verbose;
+    sim_verbose = 0;
+    srand(seed);
+    long arrival = 0;
+    for (int i = 0; i < n; i++) {
+        SimProgram prog;
+        lookup_program(known_programs[rand() % NUM_KNOWN_PROGRAMS].name, &prog);
+        arrival += rand() % (2 * gap);
+        if (procsim_spawn(&sys, &prog, arrival) != 0) {
+            printf("Error: out of memory after %d processes.\n", i);
+            break;
+        }
+    }
+    run_simulation(&sys);
+    sim_verbose = saved_verbose;
+    return 0;
+}
 
-    for(int i=0; i<MAX_MEM_PROCESSES_MAIN; ++i) {
-        mem_proc_infos[i].pid = 0; 
-        mem_proc_infos[i].num_pages_requested = 0;
+// sweep key=value ...: ranges of quantum, frames and cores, a disk algorithm
+// list, and the run shape; every combination runs in parallel into one CSV.
+static int cmd_sweep(int argc, char* argv[]) {
+    SimProgram programs[NUM_KNOWN_PROGRAMS];
+    for (int i = 0; i < NUM_KNOWN_PROGRAMS; i++) lookup_program(known_programs[i].name, &programs[i]);
+    SweepConfig cfg;
+    sweep_default_config(&cfg, programs, NUM_KNOWN_PROGRAMS);
+    const char* out = "sweep.csv";
+
+    for (int i = 1; i < argc; i++) {
+        char* value = strchr(argv[i], '=');
+        int ok = value != NULL;
+        if (ok) {
+            *value++ = '\0';
+            if (strcmp(argv[i], "quantum") == 0) ok = sweep_parse_range(value, &cfg.quantum) == 0;
+            else if (strcmp(argv[i], "frames") == 0) ok = sweep_parse_range(value, &cfg.frames) == 0;
+            else if (strcmp(argv[i], "cores") == 0) ok = sweep_parse_range(value, &cfg.cores) == 0;
+            else if (strcmp(argv[i], "disk") == 0) {
+                cfg.num_disks = 0;
+                if (strcmp(value, "fcfs") == 0 || strcmp(value, "all") == 0) cfg.disks[cfg.num_disks++] = SIM_DISK_FCFS;
+                if (strcmp(value, "elevator") == 0 || strcmp(value, "all") == 0) cfg.disks[cfg.num_disks++] = SIM_DISK_ELEVATOR;
+                ok = cfg.num_disks > 0;
+            }
+            else if (strcmp(argv[i], "workload") == 0) {
+                ok = 0;
+                for (int k = 0; k < WORKLOAD_KINDS; k++) {
+                    if (strcmp(value, workload_name(k)) == 0) {
+                        cfg.workload = k;
+                        ok = 1;
+                    }
+                }
+            }
+            else if (strcmp(argv[i], "runs") == 0) ok = (cfg.replicas = atoi(value)) > 0;
+            else if (strcmp(argv[i], "procs") == 0) ok = (cfg.processes = atoi(value)) > 0;
+            else if (strcmp(argv[i], "gap") == 0) ok = (cfg.mean_gap = atol(value)) > 0;
+            else if (strcmp(argv[i], "seed") == 0) cfg.seed = strtoull(value, NULL, 10);
+            else if (strcmp(argv[i], "threads") == 0) ok = (cfg.threads = atoi(value)) > 0;
+            else if (strcmp(argv[i], "out") == 0) out = value;
+            else ok = 0;
+        }
+        if (!ok) {
+            printf("Usage: sweep [quantum=R] [frames=R] [cores=R] [disk=fcfs|elevator|all] [runs=N] [procs=N]\n");
+            printf("             [gap=us] [workload=uniform|sequential|zipf|bursty] [seed=S] [threads=T] [out=file.csv]\n");
+            printf("R is a value, lo..hi, lo..hi:step or lo..hi*factor (e.g., sweep quantum=500..16000*2 frames=2..16 disk=all)\n");
+            return 0;
+        }
     }
+    if (cfg.threads > POOL_MAX_THREADS) cfg.threads = POOL_MAX_THREADS;
+    simulate_sweep(&cfg, out);
+    return 0;
+}
 
-    printf("Welcome to MyOS Simulator Shell!\n");
-    printf("Type 'help' for a list of commands.\n");
+static int cmd_rr(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: rr <time_quantum>\n");
+        return 0;
+    }
+    int tq = atoi(argv[1]);
+    if (tq <= 0) tq = 4; 
+    Process processes_rr[] = {{1,0,10},{2,1,5},{3,2,8}}; 
+    int num_rr = sizeof(processes_rr)/sizeof(Process);
+    simulate_round_robin(processes_rr, num_rr, tq);
+    return 0;
+}
 
-    while (1) {
-        printf("myos> ");
-        fflush(stdout); 
+static int cmd_mem_init(int argc, char* argv[]) {
+    int frames = argc > 1 ? atoi(argv[1]) : NUM_FRAMES;
+    if (frames < 1 || frames > MAX_FRAMES) {
+        printf("Frame count must be between 1 and %d.\n", MAX_FRAMES);
+        return 0;
+    }
+    init_memory_frames(frames);
+    proctable_destroy(&process_table); // The reset frames no longer back any page table
+    memory_initialized_flag = 1;
+    printf("Memory management initialized.\n");
+    return 0;
+}
 
-        if (fgets(input_line, sizeof(input_line), stdin) == NULL) {
-            printf("\nExiting MyOS shell (EOF).\n");
-            break; 
+static int cmd_mem_req(int argc, char* argv[]) {
+    if (!memory_initialized_flag) printf("Initialize memory first (mem_init).\n");
+    else if (argc < 3) printf("Usage: mem_req <pid> <num_pages>\n");
+    else {
+        int pid = atoi(argv[1]);
+        int pages = atoi(argv[2]);
+        if (pid <= 0) printf("Invalid PID.\n");
+        else if (proctable_find(&process_table, pid) != NULL) printf("PID %d already exists for memory tracking.\n", pid);
+        else {
+            PCB* pcb = proctable_create(&process_table, pid, "mem_req");
+            if (pcb == NULL) {
+                printf("Could not create a process table entry for PID %d.\n", pid);
+                return 0;
+            }
+            request_memory(&pcb->mem, pid, pages);
+            if (pcb->mem.num_pages_requested == 0) proctable_exit(&process_table, pid);
+            else pcb->state = PROC_READY;
         }
+    }
+    return 0;
+}
+
+static int cmd_mem_access(int argc, char* argv[]) {
+    if (!memory_initialized_flag) printf("Initialize memory first (mem_init).\n");
+    else if (process_table.count == 0) printf("No processes requested memory yet (mem_req).\n");
+    else if (argc < 3) printf("Usage: mem_access <pid> <page_num>\n");
+    else {
+        int pid = atoi(argv[1]);
+        int page = atoi(argv[2]);
+        PCB* pcb = proctable_find(&process_table, pid);
+        if (pcb != NULL) access_memory(&pcb->mem, pid, page);
+        else printf("PID %d not found in active memory processes.\n", pid);
+    }
+    return 0;
+}
 
-        input_line[strcspn(input_line, "\n")] = 0;
+static int cmd_mem_free(int argc, char* argv[]) {
+    if (!memory_initialized_flag) printf("Initialize memory first (mem_init).\n");
+    else if (argc < 2) printf("Usage: mem_free <pid>\n");
+    else {
+        int pid = atoi(argv[1]);
+        if (proctable_exit(&process_table, pid) == -1) printf("PID %d not found in active memory processes.\n", pid);
+    }
+    return 0;
+}
 
-        if (strlen(input_line) == 0) {
-            continue; 
+static int cmd_mem_status(int argc, char* argv[]) {
+    if(!memory_initialized_flag) {
+        printf("Initialize memory first (mem_init).\n");
+        return 0;
+    }
+    ProcessMemoryInfo** infos = malloc((size_t)(process_table.count + 1) * sizeof(ProcessMemoryInfo*));
+    if (infos == NULL) {
+        printf("Error: out of memory.\n");
+        return 0;
+    }
+    int n = 0, cursor = 0;
+    PCB* pcb;
+    while ((pcb = proctable_next(&process_table, &cursor)) != NULL) infos[n++] = &pcb->mem;
+    display_memory_status(infos, n);
+    free(infos);
+    return 0;
+}
+
+static int cmd_ps(int argc, char* argv[]) {
+    proctable_print(&process_table);
+    return 0;
+}
+
+static int cmd_fs_init(int argc, char* argv[]) {
+    init_filesystem();
+    fs_initialized_flag = 1;
+    return 0;
+}
+
+static int cmd_fs_create(int argc, char* argv[]) {
+    if(!fs_initialized_flag) printf("Initialize filesystem first (fs_init).\n");
+    else if(argc < 3) printf("Usage: fs_create <name> <size>\n");
+    else create_file_sim(argv[1], atoi(argv[2]));
+    return 0;
+}
+
+static int cmd_fs_delete(int argc, char* argv[]) {
+    if(!fs_initialized_flag) printf("Initialize filesystem first (fs_init).\n");
+    else if(argc < 2) printf("Usage: fs_delete <name>\n");
+    else delete_file_sim(argv[1]);
+    return 0;
+}
+
+static int cmd_fs_list(int argc, char* argv[]) {
+    if(!fs_initialized_flag) printf("Initialize filesystem first (fs_init).\n");
+    else list_files_sim();
+    return 0;
+}
+
+static int cmd_disk_fcfs(int argc, char* argv[]) {
+    if (argc < 4) { 
+        printf("Usage: disk_fcfs <head_pos> <total_cylinders> <req1> [req2 ...]\n");
+        return 0;
+    }
+    int head = atoi(argv[1]);
+    int cylinders = atoi(argv[2]);
+    int num_reqs = argc - 3;
+    int* requests = malloc((size_t)num_reqs * sizeof(int));
+    if (requests == NULL) {
+        printf("Out of memory for %d disk requests.\n", num_reqs);
+        return 0;
+    }
+    for (int i = 0; i < num_reqs; ++i) requests[i] = atoi(argv[i + 3]);
+    simulate_fcfs_disk_scheduling(requests, num_reqs, head, cylinders);
+    free(requests);
+    return 0;
+}
+
+static int cmd_disk_queue(int argc, char* argv[]) {
+    if (argc < 3 || (strcmp(argv[2], "gen") == 0 && argc < 4)) {
+        printf("Usage: disk_queue <head_cyl> <trace_file> | disk_queue <head_cyl> gen <n> [seed]\n");
+        return 0;
+    }
+    int head = atoi(argv[1]);
+    DiskRequest* trace = NULL;
+    int n;
+    if (strcmp(argv[2], "gen") == 0) {
+        n = atoi(argv[3]);
+        unsigned int seed = (argc >= 5) ? (unsigned int)strtoul(argv[4], NULL, 10) : 42;
+        trace = (n > 0) ? malloc((size_t)n * sizeof(DiskRequest)) : NULL;
+        if (trace == NULL) {
+            printf("Invalid request count %d.\n", n);
+            n = -1;
+        } else {
+            DiskModel model;
+            disk_default_model(&model);
+            disk_generate_trace(trace, n, seed, &model);
         }
-        
-        for(int i=0; i < MAX_ARGS; ++i) args[i] = NULL;
+    } else {
+        n = disk_load_trace(argv[2], &trace);
+    }
+    if (n >= 0) simulate_disk_queue(trace, n, head);
+    free(trace);
+    return 0;
+}
 
-        arg_count = parse_command(input_line, &command, args);
+static int cmd_raid(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <0|1|5> <devices> [hdd|ssd] [n] [seed]\n", argv[0]);
+        return 0;
+    }
+    int level = atoi(argv[1]);
+    int devices = atoi(argv[2]);
+    int ssd = (argc >= 4 && strcmp(argv[3], "ssd") == 0);
+    int n = (argc >= 5) ? atoi(argv[4]) : 5000;
+    unsigned int seed = (argc >= 6) ? (unsigned int)strtoul(argv[5], NULL, 10) : 42;
+    if (strcmp(argv[0], "raid") == 0) simulate_raid(level, devices, ssd, n, seed);
+    else simulate_raid_scaling(level, devices, ssd, n, seed);
+    return 0;
+}
 
-        if (arg_count == 0 || command == NULL) {
-            if(command) free(command); 
-            command = NULL;
-            continue; 
+static int cmd_disk_real(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: disk_real <file> [uring|pread] [queue_depth] [direct|buffered] [n]\n");
+        return 0;
+    }
+    DiskIOConfig io_cfg;
+    io_cfg.path = argv[1];
+    io_cfg.backend = (argc >= 3 && strcmp(argv[2], "pread") == 0) ? DISKIO_BACKEND_PREAD : DISKIO_BACKEND_URING;
+    io_cfg.queue_depth = (argc >= 4) ? atoi(argv[3]) : 32;
+    io_cfg.direct = (argc >= 5 && strcmp(argv[4], "direct") == 0);
+    int n = (argc >= 6) ? atoi(argv[5]) : 2000;
+    DiskRequest* trace = (n > 0) ? malloc((size_t)n * sizeof(DiskRequest)) : NULL;
+    if (trace == NULL) {
+        printf("Invalid request count %d.\n", n);
+        return 0;
+    }
+    DiskModel model;
+    disk_default_model(&model);
+    disk_generate_trace(trace, n, 42, &model);
+    simulate_disk_real_io(&io_cfg, trace, n, 0);
+    free(trace);
+    return 0;
+}
+
+static int cmd_stats(int argc, char* argv[]) {
+    metrics_print();
+    return 0;
+}
+
+static int cmd_stats_dump(int argc, char* argv[]) {
+    if (argc < 2) {
+        printf("Usage: stats_dump <file> [prom|json]\n");
+        return 0;
+    }
+    int json = (argc >= 3 && strcmp(argv[2], "json") == 0);
+    FILE* out = fopen(argv[1], "w");
+    if (out == NULL) {
+        printf("Cannot open '%s' for writing.\n", argv[1]);
+        return 0;
+    }
+    if (json) metrics_dump_json(out);
+    else metrics_dump_prometheus(out);
+    fclose(out);
+    printf("Metrics written to '%s' (%s).\n", argv[1], json ? "JSON" : "Prometheus text");
+    return 0;
+}
+
+static int cmd_stats_reset(int argc, char* argv[]) {
+    metrics_reset();
+    printf("Metrics reset.\n");
+    return 0;
+}
+
+static const Command commands[] = {
+    {"help", cmd_help, "help                            - Show this help message"},
+    {"exit", cmd_exit, "exit                            - Exit the MyOS shell"},
+    {"rr", cmd_rr, "rr <time_quantum>               - Simulate Round Robin (e.g., rr 4)"},
+    {"mem_init", cmd_mem_init, "mem_init [frames]               - Initialize Memory Management (default 8 frames)"},
+    {"mem_req", cmd_mem_req, "mem_req <pid> <num_pages>       - Request memory (e.g., mem_req 101 3)"},
+    {"mem_access", cmd_mem_access, "mem_access <pid> <page_num>     - Access memory (e.g., mem_access 101 0)"},
+    {"mem_free", cmd_mem_free, "mem_free <pid>                  - Exit a process and return its frames (e.g., mem_free 101)"},
+    {"mem_status", cmd_mem_status, "mem_status                      - Display Memory Status"},
+    {"sweep", cmd_sweep, "sweep quantum=R frames=R cores=R disk=fcfs|elevator|all ... - Parallel parameter sweep to CSV\n"
+                         "                                    (R is v, lo..hi, lo..hi:step or lo..hi*factor; run 'sweep ?' for all options)"},
+    {"ps", cmd_ps, "ps                              - List the process table"},
+    {"fs_init", cmd_fs_init, "fs_init                         - Initialize File System"},
+    {"fs_create", cmd_fs_create, "fs_create <name> <size>         - Create file (e.g., fs_create doc.txt 100)"},
+    {"fs_delete", cmd_fs_delete, "fs_delete <name>                - Delete file (e.g., fs_delete doc.txt)"},
+    {"fs_list", cmd_fs_list, "fs_list                         - List files"},
+    {"disk_fcfs", cmd_disk_fcfs, "disk_fcfs <head> <cyl> <r1> ... - FCFS Disk (e.g., disk_fcfs 50 200 98 183)"},
+    {"disk_queue", cmd_disk_queue, "disk_queue <head> <trace_file>  - Replay a timed I/O trace through the request queue\n"
+                                   "  disk_queue <head> gen <n> [seed]- Same, with a generated trace (e.g., disk_queue 50 gen 5000)"},
+    {"raid", cmd_raid, "raid <0|1|5> <devices> [hdd|ssd] [n] [seed] - Striped/mirrored/parity array of queued devices"},
+    {"raid_scale", cmd_raid, "raid_scale <0|1|5> <max_devices> [hdd|ssd] - Throughput as devices are added"},
+    {"disk_real", cmd_disk_real, "disk_real <file> [uring|pread] [qd] [direct|buffered] [n] - Issue scheduled I/O to a real file\n"
+                                 "                                    (the file is overwritten; measured vs simulated latency)"},
+    {"stats", cmd_stats, "stats                           - Show scheduler, memory, file system and disk metrics"},
+    {"stats_dump", cmd_stats_dump, "stats_dump <file> [prom|json]   - Write metrics as Prometheus text (default) or JSON"},
+    {"stats_reset", cmd_stats_reset, "stats_reset                     - Zero all metrics"},
+    {"exec_process", cmd_exec_process, "exec_process <program_name>     - Simulate full lifecycle (e.g., exec_process editor)\n"
+                                       "                                    Known programs: editor, compiler, player"},
+    {"run_programs", cmd_exec_process, "run_programs <prog> [prog...]   - Run several programs concurrently in simulated time"},
+    {"sim_load", cmd_sim_load, "sim_load <n> [cores] [seed] [gap] - Full-system throughput with n programs arriving every gap us"},
+};
+#define NUM_COMMANDS (int)(sizeof(commands) / sizeof(commands[0]))
+
+// Open-addressed hash of command names, built once at startup.
+#define COMMAND_TABLE_SIZE 64 // Power of two, well above NUM_COMMANDS
+static const Command* command_table[COMMAND_TABLE_SIZE];
+
+static unsigned int hash_name(const char* s) {
+    unsigned int h = 2166136261u; // FNV-1a
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void build_command_table(void) {
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        unsigned int slot = hash_name(commands[i].name) & (COMMAND_TABLE_SIZE - 1);
+        while (command_table[slot] != NULL) slot = (slot + 1) & (COMMAND_TABLE_SIZE - 1);
+        command_table[slot] = &commands[i];
+    }
+}
+
+static const Command* find_command(const char* name) {
+    unsigned int slot = hash_name(name) & (COMMAND_TABLE_SIZE - 1);
+    while (command_table[slot] != NULL) {
+        if (strcmp(command_table[slot]->name, name) == 0) return command_table[slot];
+        slot = (slot + 1) & (COMMAND_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+static int cmd_help(int argc, char* argv[]) {
+    printf("Available commands:\n");
+    for (int i = 0; i < NUM_COMMANDS; i++) {
+        printf("  %s\n", commands[i].help);
+    }
+    return 0;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    FILE* input = stdin;
+    const char* script_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            script_path = argv[++i];
+        } else {
+            printf("Usage: %s [-f script.txt]\n", argv[0]);
+            printf("Reads commands from the script, or from stdin (no prompt when stdin is not a terminal).\n");
+            return 1;
+        }
+    }
+    if (script_path != NULL) {
+        input = fopen(script_path, "r");
+        if (input == NULL) {
+            printf("Cannot open script '%s'.\n", script_path);
+            return 1;
         }
+    }
+    // Batch mode: a script or piped stdin, run without prompts and timed
+    int batch = (script_path != NULL) || !isatty(fileno(stdin));
 
-        if (strcmp(command, "exit") == 0) {
-            printf("Exiting MyOS shell.\n");
-            free_parsed_command(command, args, arg_count);
-            break;
-        } else if (strcmp(command, "help") == 0) {
-            printf("Available commands:\n");
-            printf("  help                            - Show this help message\n");
-            printf("  exit                            - Exit the MyOS shell\n");
-            printf("  rr <time_quantum>               - Simulate Round Robin (e.g., rr 4)\n");
-            printf("  mem_init                        - Initialize Memory Management\n");
-            printf("  mem_req <pid> <num_pages>       - Request memory (e.g., mem_req 101 3)\n");
-            printf("  mem_access <pid> <page_num>     - Access memory (e.g., mem_access 101 0)\n");
-            printf("  mem_status                      - Display Memory Status\n");
-            printf("  fs_init                         - Initialize File System\n");
-            printf("  fs_create <name> <size>         - Create file (e.g., fs_create doc.txt 100)\n");
-            printf("  fs_delete <name>                - Delete file (e.g., fs_delete doc.txt)\n");
-            printf("  fs_list                         - List files\n");
-            printf("  disk_fcfs <head> <cyl> <r1> ... - FCFS Disk (e.g., disk_fcfs 50 200 98 183)\n");
-            printf("  exec_process <program_name>     - Simulate full lifecycle (e.g., exec_process editor)\n");
-            printf("                                    Known programs: editor, compiler, player\n");
-
-        } else if (strcmp(command, "exec_process") == 0) {
-            if (arg_count < 2 || args[0] == NULL) {
-                printf("Usage: exec_process <program_name>\n");
-                printf("Known programs: editor, compiler, player. Others use defaults.\n");
-            } else {
-                char* program_name_arg = args[0];
-                int process_id = 1000 + current_mem_processes_count + 1; // Semi-unique PID
-                
-                int required_pages = 3; // Default
-                char file_to_access[50] = "default_data.txt"; // Default
-                int profile_found = 0;
-
-                for (int i = 0; i < NUM_KNOWN_PROGRAMS; i++) {
-                    if (strcmp(known_programs[i].name, program_name_arg) == 0) {
-                        required_pages = known_programs[i].pages_needed;
-                        strncpy(file_to_access, known_programs[i].file_to_access, sizeof(file_to_access) - 1);
-                        file_to_access[sizeof(file_to_access) - 1] = '\0';
-                        profile_found = 1;
-                        printf("[OS_SIM_INFO] Using profile for known program: '%s'\n", program_name_arg);
-                        break;
-                    }
-                }
-                if (!profile_found) {
-                    printf("[OS_SIM_INFO] Program '%s' not in known profiles. Using default settings (Pages: %d, File: %s).\n", 
-                           program_name_arg, required_pages, file_to_access);
-                }
+    proctable_init(&process_table);
+    build_command_table();
 
-                printf("\n--- Simulating Lifecycle for Program: %s (PID: %d) ---\n", program_name_arg, process_id);
-
-                printf("[OS_SIM | PID: %d | State: NEW] Process '%s' created.\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] System identifies '%s' for execution (located on simulated secondary storage).\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] Disk I/O: Fetching executable for '%s'...\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] Disk I/O: '%s' loaded from secondary storage into a temporary staging area.\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] Memory Manager: Requesting %d pages for '%s'...\n", process_id, required_pages, program_name_arg);
-                
-                if (!memory_initialized_flag) {
-                    init_memory_management(); 
-                    memory_initialized_flag = 1;
-                    current_mem_processes_count = 0; // Reset count as mem_init was called
-                     for(int i=0; i<MAX_MEM_PROCESSES_MAIN; ++i) {mem_proc_infos[i].pid = 0; mem_proc_infos[i].num_pages_requested = 0;}
-                }
-                
-                int mem_idx = -1;
-                // Find an unused slot OR the next available if array is not full
-                for(int i=0; i < MAX_MEM_PROCESSES_MAIN; ++i) {
-                    if(mem_proc_infos[i].pid == 0) { // Found an unused slot (e.g. after a process finished and was cleaned up - not fully implemented cleanup)
-                        mem_idx = i;
-                        break;
-                    }
-                }
-                if (mem_idx == -1) { // No empty slot found, try to use next if available
-                    if (current_mem_processes_count < MAX_MEM_PROCESSES_MAIN) {
-                        mem_idx = current_mem_processes_count;
-                    } else {
-                        printf("[OS_SIM_ERROR | PID: %d] No space in mem_proc_infos array to track new process memory. Increase MAX_MEM_PROCESSES_MAIN.\n", process_id);
-                        free_parsed_command(command, args, arg_count); command = NULL;
-                        continue;
-                    }
-                }
-                
-                request_memory(&mem_proc_infos[mem_idx], process_id, required_pages);
-                
-                if(mem_proc_infos[mem_idx].num_pages_requested > 0) { // If request_memory was successful
-                    if(mem_proc_infos[mem_idx].pid == process_id) { // Ensure this slot is now for our current process_id
-                        // Only increment current_mem_processes_count if this is a truly new slot being used,
-                        // or if request_memory itself should return whether it's a new process.
-                        // For simplicity, if mem_idx was an empty slot (pid 0) or points to a new process slot, count it.
-                        // This logic can be tricky if processes are "removed" and slots are reused.
-                        // Let's assume request_memory sets the pid and we can check if it was a new assignment.
-                        // A simpler way for this demo: if we got a valid mem_idx and request_memory succeeded, we assume it's managed.
-                        // The current_mem_processes_count tracks how many active processes we *think* we have.
-                        int is_new_active_process_slot = 1; // Assume true for now for demo simplicity
-                        if(is_new_active_process_slot && mem_idx >= current_mem_processes_count) {
-                            // This implies we're using a slot at the end of the currently "filled" portion
-                             current_mem_processes_count = mem_idx + 1;
-                        } else if (is_new_active_process_slot && mem_proc_infos[mem_idx].pid == process_id) {
-                            // This could be a reused slot, current_mem_processes_count might not need to change if it reflects "highest index used + 1"
-                            // This part needs more robust tracking if processes are properly deallocated
-                        }
-                        // For this demo, let's simplify: if a slot is used for this new process, and it's beyond current_mem_processes_count, update.
-                        // A better approach: init_memory_management resets current_mem_processes_count.
-                        // Each successful unique PID request increments it.
-                        // To ensure it's truly unique for this session if previous runs filled array:
-                        int pid_already_exists = 0;
-                        for(int k=0; k<current_mem_processes_count; ++k) {
-                            if (k != mem_idx && mem_proc_infos[k].pid == process_id) {
-                                pid_already_exists = 1; break;
-                            }
-                        }
-                        if (!pid_already_exists && mem_idx == current_mem_processes_count && current_mem_processes_count < MAX_MEM_PROCESSES_MAIN) {
-                            current_mem_processes_count++;
-                        }
-
-
-                        for (int i = 0; i < required_pages; i++) {
-                            printf("[OS_SIM | PID: %d | Action] Memory Manager: Loading page %d into main memory...\n", process_id, i);
-                            access_memory(&mem_proc_infos[mem_idx], process_id, i); 
-                        }
-                        printf("[OS_SIM | PID: %d | Action] Memory Manager: PID %d successfully loaded into main memory.\n", process_id, process_id);
-                        printf("[OS_SIM | PID: %d | State: READY] Process '%s' is in main memory, waiting for CPU.\n", process_id, program_name_arg);
-                    } else {
-                         printf("[OS_SIM_ERROR | PID: %d] Memory slot confusion after request_memory for '%s'.\n", process_id, program_name_arg);
-                         free_parsed_command(command, args, arg_count); command = NULL;
-                         continue;
-                    }
-                } else {
-                    printf("[OS_SIM_ERROR | PID: %d] Memory request failed for '%s'. Cannot proceed to READY state.\n", process_id, program_name_arg);
-                    free_parsed_command(command, args, arg_count); command = NULL;
-                    continue;
-                }
-        
-                printf("[OS_SIM | PID: %d | Action] Scheduler: Dispatching process '%s' to CPU...\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | State: RUNNING] Process '%s' is now executing instructions on the CPU.\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] '%s' is performing its computation...\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] Process '%s' requests to open file '%s'.\n", process_id, program_name_arg, file_to_access);
-                printf("[OS_SIM | PID: %d | State: WAITING] Process '%s' blocked, waiting for file '%s' operation.\n", process_id, program_name_arg, file_to_access);
-                
-                if (!fs_initialized_flag) {
-                    init_filesystem(); 
-                    fs_initialized_flag = 1;
-                }
-                printf("[OS_SIM | PID: %d | Action] File System: Servicing I/O request for '%s'...\n", process_id, file_to_access);
-                
-                int file_exists_flag = 0;
-                // Accessing global 'file_system' array - ensure filesystem.h defines File and MAX_FILES
-                // And that file_system is declared in filesystem.c without static, or provide a helper.
-                // For this demo, assuming direct access is possible via extern.
-                for(int f_idx=0; f_idx < MAX_FILES; ++f_idx) { // MAX_FILES should be from filesystem.h
-                    if(file_system[f_idx].allocated && strcmp(file_system[f_idx].name, file_to_access) == 0) {
-                        file_exists_flag = 1;
-                        break;
-                    }
-                }
+    if (!batch) {
+        printf("Welcome to MyOS Simulator Shell!\n");
+        printf("Type 'help' for a list of commands.\n");
+    }
 
-                if (file_exists_flag) {
-                    printf("[OS_SIM | PID: %d | Action] File System: File '%s' found and opened.\n", process_id, file_to_access);
-                } else {
-                    printf("[OS_SIM | PID: %d | Action] File System: File '%s' not found. Creating it...\n", process_id, file_to_access);
-                    create_file_sim(file_to_access, 20); 
-                    printf("[OS_SIM | PID: %d | Action] File System: File '%s' created and opened.\n", process_id, file_to_access);
-                }
-                printf("[OS_SIM | PID: %d | Action] File System: I/O operation for '%s' completed.\n", process_id, file_to_access);
-                printf("[OS_SIM | PID: %d | State: READY] Process '%s' moved back to Ready Queue after I/O.\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] Scheduler: Dispatching process '%s' to CPU again...\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | State: RUNNING] Process '%s' continues execution...\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] '%s' performing final computations...\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | State: TERMINATED] Process '%s' has completed its execution.\n", process_id, program_name_arg);
-                printf("[OS_SIM | PID: %d | Action] OS is deallocating memory and removing PID %d from process table (conceptually).\n", process_id, process_id);
-                // To truly deallocate:
-                // 1. Mark mem_proc_infos[mem_idx].pid = 0; (or some other unused indicator)
-                // 2. Invalidate its page table entries.
-                // 3. Free its frames in physical_frames[] and associated maps in memory.c
-                // This would make current_mem_processes_count management more complex (it would decrease).
-                // For now, FIFO replacement handles frame reuse eventually.
-                if(mem_idx != -1 && mem_proc_infos[mem_idx].pid == process_id) { // Basic cleanup for next exec_process
-                    // This doesn't free the frames yet, but makes the slot available
-                   // mem_proc_infos[mem_idx].pid = 0; 
-                   // mem_proc_infos[mem_idx].num_pages_requested = 0;
-                   // A more robust cleanup in memory.c would be needed to free frames.
-                   // For now, if mem_init is called, it clears everything.
-                }
+    char* line = NULL;
+    size_t line_cap = 0;
+    int args_cap = INITIAL_ARGS;
+    char** args = malloc((size_t)args_cap * sizeof(char*));
+    long commands_run = 0;
+    double start = now_seconds();
+
+    while (args != NULL) {
+        if (!batch) {
+            printf("myos> ");
+            fflush(stdout); 
+        }
 
+        if (getline(&line, &line_cap, input) < 0) {
+            if (!batch) printf("\nExiting MyOS shell (EOF).\n");
+            break; 
+        }
 
-                printf("--- Simulation Lifecycle for PID %d (%s) Ended ---\n", process_id, program_name_arg);
-            } // end of arg_count check for exec_process
-        } // end of exec_process command
-        
-        // ... other commands like rr, mem_init, etc. from previous main.c version
-        else if (strcmp(command, "rr") == 0) {
-            if (arg_count < 2 || args[0] == NULL) {
-                printf("Usage: rr <time_quantum>\n");
-            } else {
-                int tq = atoi(args[0]);
-                if (tq <= 0) tq = 4; 
-                 Process processes_rr[] = {{1,0,10},{2,1,5},{3,2,8}}; 
-                int num_rr = sizeof(processes_rr)/sizeof(Process);
-                simulate_round_robin(processes_rr, num_rr, tq);
-            }
-        } else if (strcmp(command, "mem_init") == 0) {
-            init_memory_management();
-            current_mem_processes_count = 0;
-            memory_initialized_flag = 1;
-             for(int i=0; i<MAX_MEM_PROCESSES_MAIN; ++i) {
-                mem_proc_infos[i].pid = 0;
-                mem_proc_infos[i].num_pages_requested = 0;
-            }
-            printf("Memory management initialized.\n");
-        } else if (strcmp(command, "mem_req") == 0) {
-            if (!memory_initialized_flag) printf("Initialize memory first (mem_init).\n");
-            else if (arg_count < 3 || args[0] == NULL || args[1] == NULL) printf("Usage: mem_req <pid> <num_pages>\n");
-            else if (current_mem_processes_count >= MAX_MEM_PROCESSES_MAIN) printf("Max memory processes (%d) reached.\n", MAX_MEM_PROCESSES_MAIN);
-            else {
-                int pid = atoi(args[0]);
-                int pages = atoi(args[1]);
-                if (pid > 0) {
-                    int existing_idx = -1;
-                    for(int i=0; i < current_mem_processes_count; ++i) if(mem_proc_infos[i].pid == pid) existing_idx = i;
-                    
-                    if(existing_idx != -1) printf("PID %d already exists for memory tracking.\n", pid);
-                    else {
-                        int next_slot = -1; // Find truly empty slot or next available
-                        for(int i=0; i < MAX_MEM_PROCESSES_MAIN; ++i) if(mem_proc_infos[i].pid == 0) {next_slot = i; break;}
-                        if (next_slot == -1 && current_mem_processes_count < MAX_MEM_PROCESSES_MAIN) next_slot = current_mem_processes_count;
-
-                        if (next_slot != -1) {
-                            request_memory(&mem_proc_infos[next_slot], pid, pages);
-                            if(mem_proc_infos[next_slot].num_pages_requested > 0 && mem_proc_infos[next_slot].pid == pid) {
-                                if (next_slot >= current_mem_processes_count) current_mem_processes_count = next_slot + 1;
-                            }
-                        } else {
-                             printf("Could not find slot for new PID %d in mem_proc_infos.\n", pid);
-                        }
-                    }
-                } else printf("Invalid PID.\n");
-            }
-        } else if (strcmp(command, "mem_access") == 0) {
-            if (!memory_initialized_flag) printf("Initialize memory first (mem_init).\n");
-            else if (current_mem_processes_count == 0 && MAX_MEM_PROCESSES_MAIN > 0 && mem_proc_infos[0].pid == 0 ) printf("No processes requested memory yet (mem_req).\n"); // Check if any process is active
-            else if (arg_count < 3 || args[0] == NULL || args[1] == NULL) printf("Usage: mem_access <pid> <page_num>\n");
-            else {
-                int pid = atoi(args[0]);
-                int page = atoi(args[1]);
-                int idx = -1;
-                for(int i=0; i<current_mem_processes_count; ++i) if(mem_proc_infos[i].pid == pid) idx = i; // Search up to current_mem_processes_count
-                if(idx != -1) access_memory(&mem_proc_infos[idx], pid, page);
-                else printf("PID %d not found in active memory processes.\n", pid);
-            }
-        } else if (strcmp(command, "mem_status") == 0) {
-            if(!memory_initialized_flag) printf("Initialize memory first (mem_init).\n");
-            else display_memory_status(mem_proc_infos, current_mem_processes_count);
-        } else if (strcmp(command, "fs_init") == 0) {
-            init_filesystem();
-            fs_initialized_flag = 1;
-        } else if (strcmp(command, "fs_create") == 0) {
-            if(!fs_initialized_flag) printf("Initialize filesystem first (fs_init).\n");
-            else if(arg_count < 3 || args[0] == NULL || args[1] == NULL) printf("Usage: fs_create <name> <size>\n");
-            else create_file_sim(args[0], atoi(args[1]));
-        } else if (strcmp(command, "fs_delete") == 0) {
-            if(!fs_initialized_flag) printf("Initialize filesystem first (fs_init).\n");
-            else if(arg_count < 2 || args[0] == NULL) printf("Usage: fs_delete <name>\n");
-            else delete_file_sim(args[0]);
-        } else if (strcmp(command, "fs_list") == 0) {
-            if(!fs_initialized_flag) printf("Initialize filesystem first (fs_init).\n");
-            else list_files_sim();
-        } else if (strcmp(command, "disk_fcfs") == 0) {
-            if (arg_count < 4) { 
-                printf("Usage: disk_fcfs <head_pos> <total_cylinders> <req1> [req2 ...]\n");
-            } else {
-                int head = atoi(args[0]);
-                int cylinders = atoi(args[1]);
-                int requests[MAX_DISK_REQUESTS];
-                int num_reqs = 0;
-                for (int i = 2; i < arg_count -1 && num_reqs < MAX_DISK_REQUESTS; ++i) { 
-                     if(args[i] != NULL) {
-                        requests[num_reqs++] = atoi(args[i]);
-                     }
-                }
-                simulate_fcfs_disk_scheduling(requests, num_reqs, head, cylinders);
-            }
+        int arg_count = parse_command(line, &args, &args_cap);
+        if (arg_count == 0 || args[0][0] == '#') {
+            continue; 
         }
-        // End of other commands
-        else {
-            printf("Unknown command: '%s'. Type 'help' for available commands.\n", command);
+
+        commands_run++;
+        const Command* cmd = find_command(args[0]);
+        if (cmd == NULL) {
+            printf("Unknown command: '%s'. Type 'help' for available commands.\n", args[0]);
+        } else if (cmd->run(arg_count, args) == SHELL_EXIT) {
+            break;
         }
-        free_parsed_command(command, args, arg_count); 
-        command = NULL; 
-    } // end while(1)
+    }
+
+    if (batch) {
+        double elapsed = now_seconds() - start;
+        printf("Batch complete: %ld commands in %.3f s (%.0f commands/sec)\n",
+               commands_run, elapsed, elapsed > 0 ? commands_run / elapsed : 0.0);
+    }
+    free(line);
+    free(args);
+    if (input != stdin) fclose(input);
     return 0;
 }
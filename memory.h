@@ -3,7 +3,8 @@
 
 #define TOTAL_MEMORY_SIZE 128 // Total physical memory in KB (example)
 #define PAGE_SIZE 16          // Page size in KB (example)
-#define NUM_FRAMES (TOTAL_MEMORY_SIZE / PAGE_SIZE)
+#define NUM_FRAMES (TOTAL_MEMORY_SIZE / PAGE_SIZE) // Default frame count
+#define MAX_FRAMES 256
 #define MAX_PAGES_PER_PROCESS 10 // Max logical pages a process can have
 
 typedef struct {
@@ -17,10 +18,28 @@ typedef struct {
     int num_pages_requested; // How many pages this process needs
 } ProcessMemoryInfo;
 
+// One simulated physical memory. The functions below operate on mem_state,
+// which every thread starts out pointing at the shell's instance; a thread
+// running its own simulation points it at a MemoryState of its own.
+typedef struct {
+    int num_frames;
+    int physical_frames[MAX_FRAMES]; // PID using the frame, or -1 if free
+    int frame_to_pid_map[MAX_FRAMES];
+    int frame_to_page_num_map[MAX_FRAMES]; // Which page of that PID is in the frame
+    ProcessMemoryInfo* frame_to_process_info_map[MAX_FRAMES]; // Owner of the frame
+    int page_fault_count;
+    int page_hit_count;
+    int next_frame_to_replace_fifo;
+} MemoryState;
+
+extern __thread MemoryState* mem_state;
+
 void init_memory_management();
+void init_memory_frames(int num_frames); // Same, with num_frames (1..MAX_FRAMES) frames
 void request_memory(ProcessMemoryInfo* p_info, int pid, int num_pages);
 void access_memory(ProcessMemoryInfo* p_info, int pid, int page_num);
-void display_memory_status(ProcessMemoryInfo p_infos[], int num_processes); // Modified to take array
+int release_memory(ProcessMemoryInfo* p_info); // Frees the process's frames, returns how many
+void display_memory_status(ProcessMemoryInfo* const p_infos[], int num_processes);
 int get_page_fault_count();
 
 #endif // MEMORY_H
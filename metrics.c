@@ -0,0 +1,142 @@
+/**
+ * metrics.c
+ * Registry of the simulator's counters, gauges and log2-bucketed histograms,
+ * with a text summary and Prometheus / JSON exporters.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "metrics.h"
+
+__thread int metrics_enabled = 1;
+
+#define METRIC(var, name, type, help) Metric var = {name, help, type, 0, 0, 0, {0}}
+
+METRIC(metric_sched_context_switches, "sched_context_switches_total", METRIC_COUNTER, "Processes dispatched to the CPU");
+METRIC(metric_sched_completed, "sched_processes_completed_total", METRIC_COUNTER, "Processes run to completion");
+METRIC(metric_sched_waiting_time, "sched_waiting_time", METRIC_HISTOGRAM, "Per-process waiting time in rr time units");
+METRIC(metric_sched_turnaround_time, "sched_turnaround_time", METRIC_HISTOGRAM, "Per-process turnaround time in rr time units");
+METRIC(metric_sim_waiting_time, "sim_waiting_time_us", METRIC_HISTOGRAM, "Per-process ready-queue wait in the full-system simulation, microseconds");
+METRIC(metric_sim_turnaround_time, "sim_turnaround_time_us", METRIC_HISTOGRAM, "Per-process turnaround in the full-system simulation, microseconds");
+METRIC(metric_mem_page_faults, "mem_page_faults_total", METRIC_COUNTER, "Page accesses that missed physical memory");
+METRIC(metric_mem_page_hits, "mem_page_hits_total", METRIC_COUNTER, "Page accesses served from a resident frame");
+METRIC(metric_mem_evictions, "mem_evictions_total", METRIC_COUNTER, "Frames taken from another page by FIFO replacement");
+METRIC(metric_mem_frames_used, "mem_frames_used", METRIC_GAUGE, "Physical frames currently holding a page");
+METRIC(metric_fs_creates, "fs_creates_total", METRIC_COUNTER, "Files created");
+METRIC(metric_fs_deletes, "fs_deletes_total", METRIC_COUNTER, "Files deleted");
+METRIC(metric_fs_lookups, "fs_lookups_total", METRIC_COUNTER, "Name lookups, including those done by create and delete");
+METRIC(metric_fs_lookup_length, "fs_lookup_length", METRIC_HISTOGRAM, "Directory slots examined per lookup");
+METRIC(metric_fs_files, "fs_files", METRIC_GAUGE, "Files currently allocated");
+METRIC(metric_disk_requests, "disk_requests_total", METRIC_COUNTER, "Requests submitted to a disk queue");
+METRIC(metric_disk_dispatches, "disk_dispatches_total", METRIC_COUNTER, "Requests sent to the head after merging");
+METRIC(metric_disk_merges, "disk_merges_total", METRIC_COUNTER, "Front and back merges in disk queues");
+METRIC(metric_disk_seek_distance, "disk_seek_distance", METRIC_HISTOGRAM, "Cylinders travelled per dispatched request");
+METRIC(metric_disk_latency, "disk_latency_us", METRIC_HISTOGRAM, "Request latency from arrival to completion in microseconds");
+
+static Metric* registry[] = {
+    &metric_sched_context_switches, &metric_sched_completed,
+    &metric_sched_waiting_time, &metric_sched_turnaround_time,
+    &metric_sim_waiting_time, &metric_sim_turnaround_time,
+    &metric_mem_page_faults, &metric_mem_page_hits, &metric_mem_evictions, &metric_mem_frames_used,
+    &metric_fs_creates, &metric_fs_deletes, &metric_fs_lookups, &metric_fs_lookup_length, &metric_fs_files,
+    &metric_disk_requests, &metric_disk_dispatches, &metric_disk_merges,
+    &metric_disk_seek_distance, &metric_disk_latency,
+};
+#define NUM_METRICS (int)(sizeof(registry) / sizeof(registry[0]))
+
+static const char* type_names[] = {"counter", "gauge", "histogram"};
+
+int metrics_count(void) {
+    return NUM_METRICS;
+}
+
+Metric* metrics_get(int index) {
+    return (index >= 0 && index < NUM_METRICS) ? registry[index] : NULL;
+}
+
+Metric* metrics_find(const char* name) {
+    for (int i = 0; i < NUM_METRICS; i++) {
+        if (strcmp(registry[i]->name, name) == 0) return registry[i];
+    }
+    return NULL;
+}
+
+void metrics_reset(void) {
+    for (int i = 0; i < NUM_METRICS; i++) {
+        Metric* m = registry[i];
+        m->value = m->count = m->sum = 0;
+        memset(m->buckets, 0, sizeof(m->buckets));
+    }
+}
+
+static long bucket_upper(int b) {
+    return b == 0 ? 0 : (1L << b) - 1;
+}
+
+long metrics_quantile(const Metric* m, double q) {
+    if (m->count == 0) return 0;
+    long rank = (long)(q * (m->count - 1)) + 1;
+    long seen = 0;
+    for (int b = 0; b < METRIC_HIST_BUCKETS; b++) {
+        seen += m->buckets[b];
+        if (seen >= rank) return bucket_upper(b);
+    }
+    return bucket_upper(METRIC_HIST_BUCKETS - 1);
+}
+
+void metrics_print(void) {
+    printf("\n--- Simulator Metrics ---\n");
+    for (int i = 0; i < NUM_METRICS; i++) {
+        const Metric* m = registry[i];
+        if (m->type == METRIC_HISTOGRAM) {
+            printf("%-32s count %-9ld mean %-10.1f p50<=%-8ld p95<=%-8ld p99<=%ld\n", m->name, m->count,
+                   m->count > 0 ? (double)m->sum / m->count : 0.0,
+                   metrics_quantile(m, 0.50), metrics_quantile(m, 0.95), metrics_quantile(m, 0.99));
+        } else {
+            printf("%-32s %ld\n", m->name, m->value);
+        }
+    }
+}
+
+void metrics_dump_prometheus(FILE* out) {
+    for (int i = 0; i < NUM_METRICS; i++) {
+        const Metric* m = registry[i];
+        fprintf(out, "# HELP myos_%s %s\n", m->name, m->help);
+        fprintf(out, "# TYPE myos_%s %s\n", m->name, type_names[m->type]);
+        if (m->type != METRIC_HISTOGRAM) {
+            fprintf(out, "myos_%s %ld\n", m->name, m->value);
+            continue;
+        }
+        long cumulative = 0;
+        for (int b = 0; b < METRIC_HIST_BUCKETS - 1; b++) {
+            cumulative += m->buckets[b];
+            fprintf(out, "myos_%s_bucket{le=\"%ld\"} %ld\n", m->name, bucket_upper(b), cumulative);
+        }
+        fprintf(out, "myos_%s_bucket{le=\"+Inf\"} %ld\n", m->name, m->count);
+        fprintf(out, "myos_%s_sum %ld\n", m->name, m->sum);
+        fprintf(out, "myos_%s_count %ld\n", m->name, m->count);
+    }
+}
+
+void metrics_dump_json(FILE* out) {
+    fprintf(out, "{\n");
+    for (int i = 0; i < NUM_METRICS; i++) {
+        const Metric* m = registry[i];
+        fprintf(out, "  \"%s\": {\"type\": \"%s\"", m->name, type_names[m->type]);
+        if (m->type != METRIC_HISTOGRAM) {
+            fprintf(out, ", \"value\": %ld}", m->value);
+        } else {
+            fprintf(out, ", \"count\": %ld, \"sum\": %ld, \"p50\": %ld, \"p95\": %ld, \"p99\": %ld, \"buckets\": [",
+                    m->count, m->sum, metrics_quantile(m, 0.50), metrics_quantile(m, 0.95), metrics_quantile(m, 0.99));
+            // Only non-empty buckets, as [upper_bound, count] pairs
+            int first = 1;
+            for (int b = 0; b < METRIC_HIST_BUCKETS; b++) {
+                if (m->buckets[b] == 0) continue;
+                fprintf(out, "%s[%ld, %ld]", first ? "" : ", ", bucket_upper(b), m->buckets[b]);
+                first = 0;
+            }
+            fprintf(out, "]}");
+        }
+        fprintf(out, "%s\n", i + 1 < NUM_METRICS ? "," : "");
+    }
+    fprintf(out, "}\n");
+}
@@ -0,0 +1,91 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+
+#define METRIC_COUNTER   0
+#define METRIC_GAUGE     1
+#define METRIC_HISTOGRAM 2
+
+// Bucket 0 holds values <= 0, bucket i holds [2^(i-1), 2^i - 1]; the last one is open-ended.
+#define METRIC_HIST_BUCKETS 40
+
+typedef struct {
+    const char* name;
+    const char* help;
+    int type;
+    long value;   // Counter or gauge
+    long count;   // Histogram observations...
+    long sum;     // ...and their total
+    long buckets[METRIC_HIST_BUCKETS];
+} Metric;
+
+// Scheduler
+extern Metric metric_sched_context_switches;
+extern Metric metric_sched_completed;
+extern Metric metric_sched_waiting_time;
+extern Metric metric_sched_turnaround_time;
+extern Metric metric_sim_waiting_time;
+extern Metric metric_sim_turnaround_time;
+// Memory
+extern Metric metric_mem_page_faults;
+extern Metric metric_mem_page_hits;
+extern Metric metric_mem_evictions;
+extern Metric metric_mem_frames_used;
+// File system
+extern Metric metric_fs_creates;
+extern Metric metric_fs_deletes;
+extern Metric metric_fs_lookups;
+extern Metric metric_fs_lookup_length;
+extern Metric metric_fs_files;
+// Disk
+extern Metric metric_disk_requests;
+extern Metric metric_disk_dispatches;
+extern Metric metric_disk_merges;
+extern Metric metric_disk_seek_distance;
+extern Metric metric_disk_latency;
+
+// Recording is a relaxed atomic add: no locks, safe from the RAID device threads.
+// A thread that runs private simulations (sweep workers) clears metrics_enabled
+// so its runs neither contend on nor overwrite the shell's metrics.
+extern __thread int metrics_enabled;
+
+static inline void metric_add(Metric* m, long n) {
+    if (!metrics_enabled) return;
+    __atomic_fetch_add(&m->value, n, __ATOMIC_RELAXED);
+}
+
+static inline void metric_inc(Metric* m) {
+    metric_add(m, 1);
+}
+
+static inline void metric_set(Metric* m, long v) {
+    if (!metrics_enabled) return;
+    __atomic_store_n(&m->value, v, __ATOMIC_RELAXED);
+}
+
+static inline int metric_bucket(long v) {
+    if (v <= 0) return 0;
+    int b = 64 - __builtin_clzl((unsigned long)v);
+    return b < METRIC_HIST_BUCKETS ? b : METRIC_HIST_BUCKETS - 1;
+}
+
+static inline void metric_observe(Metric* m, long v) {
+    if (!metrics_enabled) return;
+    __atomic_fetch_add(&m->buckets[metric_bucket(v)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&m->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&m->sum, v, __ATOMIC_RELAXED);
+}
+
+int metrics_count(void);
+Metric* metrics_get(int index);
+Metric* metrics_find(const char* name);
+void metrics_reset(void);
+// Upper bound of the bucket holding the q-quantile (0..1) of a histogram.
+long metrics_quantile(const Metric* m, double q);
+
+void metrics_print(void);
+void metrics_dump_prometheus(FILE* out);
+void metrics_dump_json(FILE* out);
+
+#endif // METRICS_H
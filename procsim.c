@@ -0,0 +1,409 @@
+/**
+ * procsim.c
+ * Process lifecycle on the discrete-event engine.
+ * A program is loaded from disk, pages in its working set, computes in
+ * round-robin slices (touching pages as it goes, so it can fault and block),
+ * opens its file through the file system and the disk, computes again and
+ * exits. Many programs run at once, so CPU time, page-fault service and I/O
+ * waits interleave on shared resources.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "procsim.h"
+#include "filesystem.h"
+#include "metrics.h"
+#include "simlog.h"
+
+#define PROC_PAGE_SECTORS (PAGE_SIZE * 1024 / 512)
+#define PROC_FILE_SECTORS 16
+
+// What a process is waiting on the disk for
+#define IO_LOAD    0
+#define IO_PAGE_IN 1
+#define IO_FAULT   2
+#define IO_FILE    3
+
+// Which compute phase a process is in
+#define PHASE_START 0
+#define PHASE_RUN1  1
+#define PHASE_RUN2  2
+
+struct SimProc {
+    SimSystem* sys;
+    SimProgram prog;
+    int pid;
+    int state;
+    int phase;
+    int io_kind;
+    int next_page;
+    long compute_left;
+    long slice;
+    int io_sector;
+    int io_size;
+    long arrival;
+    long ready_since;
+    long io_since;
+    long ready_wait;
+    long io_wait;
+    unsigned int rng;
+    PCB* pcb;        // NULL before arrival and after exit
+    SimProc* next;   // Link in the ready queue or the disk queue
+};
+
+static void on_arrive(void* ctx, long arg);
+static void on_disk_done(void* ctx, long arg);
+static void on_slice_end(void* ctx, long arg);
+
+void procsim_default_config(SimConfig* cfg) {
+    cfg->cores = 1;
+    cfg->quantum = 2000;
+    cfg->context_switch = 5;
+    cfg->disk_sched = SIM_DISK_FCFS;
+    // The elevator borrows the deadline scheduler's read expiry
+    DiskQueueConfig deadline;
+    disk_default_queue_config(&deadline, DISK_SCHED_DEADLINE);
+    cfg->disk_expire = deadline.read_expire;
+    cfg->trace = 0;
+}
+
+void procsim_init(SimSystem* sys, EventEngine* engine, ProcTable* table, const SimConfig* cfg) {
+    memset(sys, 0, sizeof(*sys));
+    sys->cfg = *cfg;
+    if (sys->cfg.cores < 1) sys->cfg.cores = 1;
+    if (sys->cfg.quantum < 1) sys->cfg.quantum = 1;
+    sys->engine = engine;
+    sys->table = table;
+    sys->idle_cores = sys->cfg.cores;
+    sys->start_time = engine->now;
+    procstore_init(&sys->finished_procs);
+    disk_default_model(&sys->disk);
+}
+
+static unsigned int hash_string(const char* s) {
+    unsigned int h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int disk_sectors(const SimSystem* sys) {
+    return sys->disk.total_cylinders * sys->disk.sectors_per_cylinder;
+}
+
+// Executables and files live in the first 90% of the disk, swap in the rest.
+static int data_sector(const SimSystem* sys, const char* name, int size) {
+    int area = disk_sectors(sys) * 9 / 10 - size;
+    return (int)(hash_string(name) % (unsigned int)area) / 8 * 8;
+}
+
+static int swap_sector(const SimSystem* sys, int pid, int page) {
+    int base = disk_sectors(sys) * 9 / 10;
+    int slots = (disk_sectors(sys) - base) / PROC_PAGE_SECTORS;
+    return base + ((pid * MAX_PAGES_PER_PROCESS + page) % slots) * PROC_PAGE_SECTORS;
+}
+
+static void trace_state(SimProc* p, int state, const char* what) {
+    p->state = state;
+    if (p->pcb != NULL) p->pcb->state = state;
+    if (p->sys->cfg.trace) {
+        printf("[OS_SIM | t=%9ldus | PID: %d | State: %s] %s\n", p->sys->engine->now, p->pid, proctable_state_name(state), what);
+    }
+}
+
+static void trace_action(SimProc* p, const char* what) {
+    if (p->sys->cfg.trace) {
+        printf("[OS_SIM | t=%9ldus | PID: %d | Action] %s\n", p->sys->engine->now, p->pid, what);
+    }
+}
+
+// Elevator order: the oldest request once it has expired, otherwise the next
+// sector at or past the head, wrapping to the lowest. This is a much smaller
+// policy than the deadline scheduler in disk.c (no batches, no read/write
+// split). Returns the link pointing at the chosen request.
+static SimProc** pick_elevator(SimSystem* sys) {
+    if (sys->engine->now - sys->disk_head->io_since >= sys->cfg.disk_expire) return &sys->disk_head;
+    int head = sys->disk_cyl * sys->disk.sectors_per_cylinder;
+    SimProc** ahead = NULL;
+    SimProc** lowest = &sys->disk_head;
+    for (SimProc** link = &sys->disk_head; *link != NULL; link = &(*link)->next) {
+        int sector = (*link)->io_sector;
+        if (sector >= head && (ahead == NULL || sector < (*ahead)->io_sector)) ahead = link;
+        if (sector < (*lowest)->io_sector) lowest = link;
+    }
+    return ahead != NULL ? ahead : lowest;
+}
+
+// The event that would wake 'p' could not be posted (the heap cannot grow),
+// so 'p' is dropped. It is counted, like a rejected arrival, so the run is
+// not taken for a complete one.
+static void stall(SimProc* p, const char* what) {
+    p->sys->stalled++;
+    if (p->sys->cfg.trace) {
+        printf("[OS_SIM_ERROR | t=%9ldus | PID: %d] Out of memory scheduling %s; process stalled.\n",
+               p->sys->engine->now, p->pid, what);
+    }
+}
+
+static void start_disk(SimSystem* sys) {
+    // Loops only when a dispatch fails: the next request gets its turn
+    while (sys->disk_head != NULL && !sys->disk_busy) {
+        SimProc** link = sys->cfg.disk_sched == SIM_DISK_ELEVATOR ? pick_elevator(sys) : &sys->disk_head;
+        SimProc* p = *link;
+        *link = p->next;
+        if (sys->disk_tail == p) {
+            // Unlinked the last request: find the new tail
+            SimProc* tail = sys->disk_head;
+            while (tail != NULL && tail->next != NULL) tail = tail->next;
+            sys->disk_tail = tail;
+        }
+        p->next = NULL;
+
+        long service = disk_service_time(&sys->disk, sys->disk_cyl, p->io_sector, p->io_size);
+        if (event_post(sys->engine, service, on_disk_done, p, 0) != 0) {
+            stall(p, "its disk completion");
+            continue;
+        }
+        int cyl = p->io_sector / sys->disk.sectors_per_cylinder;
+        metric_inc(&metric_disk_requests);
+        metric_inc(&metric_disk_dispatches);
+        metric_observe(&metric_disk_seek_distance, abs(cyl - sys->disk_cyl));
+        sys->disk_cyl = (p->io_sector + p->io_size - 1) / sys->disk.sectors_per_cylinder;
+        sys->disk_busy = 1;
+        sys->disk_busy_time += service;
+        sys->disk_ios++;
+    }
+}
+
+static void disk_submit(SimProc* p, int io_kind, int sector, int size, const char* why) {
+    SimSystem* sys = p->sys;
+    p->io_kind = io_kind;
+    p->io_sector = sector;
+    p->io_size = size;
+    p->io_since = sys->engine->now;
+    p->next = NULL;
+    trace_state(p, PROC_WAITING, why);
+    if (sys->disk_tail) sys->disk_tail->next = p;
+    else sys->disk_head = p;
+    sys->disk_tail = p;
+    start_disk(sys);
+}
+
+static void try_dispatch(SimSystem* sys) {
+    while (sys->idle_cores > 0 && sys->ready_head != NULL) {
+        SimProc* p = sys->ready_head;
+        sys->ready_head = p->next;
+        if (sys->ready_head == NULL) sys->ready_tail = NULL;
+        p->next = NULL;
+        sys->idle_cores--;
+
+        p->ready_wait += sys->engine->now - p->ready_since;
+        p->slice = p->compute_left < sys->cfg.quantum ? p->compute_left : sys->cfg.quantum;
+        if (event_post(sys->engine, sys->cfg.context_switch + p->slice, on_slice_end, p, 0) != 0) {
+            sys->idle_cores++;
+            stall(p, "the end of its time slice");
+            continue;
+        }
+        sys->context_switches++;
+        metric_inc(&metric_sched_context_switches);
+        trace_state(p, PROC_RUNNING, "Scheduler dispatched the process to a CPU.");
+    }
+}
+
+static void make_ready(SimProc* p, const char* why) {
+    SimSystem* sys = p->sys;
+    p->ready_since = sys->engine->now;
+    p->next = NULL;
+    trace_state(p, PROC_READY, why);
+    if (sys->ready_tail) sys->ready_tail->next = p;
+    else sys->ready_head = p;
+    sys->ready_tail = p;
+    try_dispatch(sys);
+}
+
+// Returns 1 if touching the page faulted (the caller then waits for the disk).
+static int touch_page(SimProc* p, int page) {
+    int before = get_page_fault_count();
+    access_memory(&p->pcb->mem, p->pid, page);
+    if (get_page_fault_count() == before) return 0;
+    p->sys->page_faults++;
+    return 1;
+}
+
+static void page_in_next(SimProc* p) {
+    while (p->next_page < p->prog.pages) {
+        int page = p->next_page++;
+        if (touch_page(p, page)) {
+            disk_submit(p, IO_PAGE_IN, swap_sector(p->sys, p->pid, page), PROC_PAGE_SECTORS,
+                        "Loading working set: page fault, reading page from swap.");
+            return;
+        }
+    }
+    p->phase = PHASE_RUN1;
+    p->compute_left = p->prog.cpu_time / 2;
+    make_ready(p, "Process is in main memory, waiting for CPU.");
+}
+
+static void open_file(SimProc* p) {
+    char msg[128];
+    if (find_file_sim(p->prog.file) == -1) {
+        create_file_sim(p->prog.file, 20);
+        snprintf(msg, sizeof(msg), "File System: '%s' not found; created it, writing metadata.", p->prog.file);
+    } else {
+        snprintf(msg, sizeof(msg), "File System: opening '%s', reading from disk.", p->prog.file);
+    }
+    disk_submit(p, IO_FILE, data_sector(p->sys, p->prog.file, PROC_FILE_SECTORS), PROC_FILE_SECTORS, msg);
+}
+
+static void terminate(SimProc* p) {
+    SimSystem* sys = p->sys;
+    long now = sys->engine->now;
+    trace_state(p, PROC_TERMINATED, "Process completed; its frames were returned to the free pool.");
+    proctable_exit(sys->table, p->pid);
+    p->pcb = NULL;
+    long turnaround = now - p->arrival;
+    sys->finished++;
+    sys->last_exit = now;
+    procstore_add(&sys->finished_procs, p->arrival, p->prog.cpu_time, now, p->ready_wait);
+    sys->total_io_wait += p->io_wait;
+    metric_inc(&metric_sched_completed);
+    metric_observe(&metric_sim_turnaround_time, turnaround);
+    metric_observe(&metric_sim_waiting_time, p->ready_wait);
+}
+
+static void on_arrive(void* ctx, long arg) {
+    SimProc* p = ctx;
+    SimSystem* sys = p->sys;
+    p->pcb = proctable_create(sys->table, 0, p->prog.name);
+    if (p->pcb == NULL) {
+        sys->rejected++;
+        if (sys->cfg.trace) printf("[OS_SIM_ERROR | t=%9ldus] No free PID for '%s'; process not started.\n", sys->engine->now, p->prog.name);
+        return;
+    }
+    p->pid = p->pcb->pid;
+    request_memory(&p->pcb->mem, p->pid, p->prog.pages);
+    p->arrival = sys->engine->now;
+    trace_state(p, PROC_NEW, "Process created.");
+    int size = p->prog.pages * PROC_PAGE_SECTORS;
+    disk_submit(p, IO_LOAD, data_sector(p->sys, p->prog.name, size), size,
+                "Disk I/O: fetching the executable from secondary storage.");
+}
+
+static void on_disk_done(void* ctx, long arg) {
+    SimProc* p = ctx;
+    SimSystem* sys = p->sys;
+    sys->disk_busy = 0;
+    p->io_wait += sys->engine->now - p->io_since;
+    metric_observe(&metric_disk_latency, sys->engine->now - p->io_since);
+    start_disk(sys);
+
+    switch (p->io_kind) {
+    case IO_LOAD:
+        trace_action(p, "Executable loaded; Memory Manager paging in the working set.");
+        p->next_page = 0;
+        page_in_next(p);
+        break;
+    case IO_PAGE_IN:
+        page_in_next(p);
+        break;
+    case IO_FAULT:
+        make_ready(p, "Page fault serviced.");
+        break;
+    default:
+        p->phase = PHASE_RUN2;
+        p->compute_left = p->prog.cpu_time - p->prog.cpu_time / 2;
+        make_ready(p, "File I/O completed, back in the ready queue.");
+        break;
+    }
+}
+
+static void on_slice_end(void* ctx, long arg) {
+    SimProc* p = ctx;
+    SimSystem* sys = p->sys;
+    sys->idle_cores++;
+    sys->cpu_busy += p->slice;
+    p->compute_left -= p->slice;
+
+    if (p->compute_left > 0) {
+        // The next slice touches some page of the working set
+        p->rng = p->rng * 1103515245u + 12345u;
+        int page = (int)((p->rng >> 16) % (unsigned int)p->prog.pages);
+        if (touch_page(p, page)) {
+            disk_submit(p, IO_FAULT, swap_sector(sys, p->pid, page), PROC_PAGE_SECTORS,
+                        "Page fault while running, reading page from swap.");
+        } else {
+            make_ready(p, "Time slice expired.");
+        }
+    } else if (p->phase == PHASE_RUN1) {
+        open_file(p);
+    } else {
+        terminate(p);
+    }
+    try_dispatch(sys);
+}
+
+int procsim_spawn(SimSystem* sys, const SimProgram* prog, long delay) {
+    if (sys->num_procs == sys->capacity) {
+        int capacity = sys->capacity ? sys->capacity * 2 : 64;
+        SimProc** procs = realloc(sys->procs, (size_t)capacity * sizeof(SimProc*));
+        if (procs == NULL) return -1;
+        sys->procs = procs;
+        sys->capacity = capacity;
+    }
+    SimProc* p = calloc(1, sizeof(SimProc));
+    if (p == NULL) return -1;
+    p->sys = sys;
+    p->prog = *prog;
+    if (p->prog.pages < 1) p->prog.pages = 1;
+    if (p->prog.pages > MAX_PAGES_PER_PROCESS) p->prog.pages = MAX_PAGES_PER_PROCESS;
+    p->state = PROC_NEW;
+    p->phase = PHASE_START;
+    p->rng = (unsigned int)(sys->num_procs + 1) * 2654435761u;
+    if (event_post(sys->engine, delay, on_arrive, p, 0) != 0) {
+        free(p);
+        return -1;
+    }
+    sys->procs[sys->num_procs++] = p;
+    return 0;
+}
+
+long procsim_run(SimSystem* sys) {
+    return event_run(sys->engine, -1);
+}
+
+void procsim_report(const SimSystem* sys, long events, double wall_seconds) {
+    long span = sys->last_exit - sys->start_time;
+    int n = sys->finished;
+    printf("\n--- Full-System Simulation Summary ---\n");
+    printf("Processes: %d finished of %d | Cores: %d | Quantum: %ldus | Disk: %s\n",
+           n, sys->num_procs, sys->cfg.cores, sys->cfg.quantum,
+           sys->cfg.disk_sched == SIM_DISK_ELEVATOR ? "elevator" : "fcfs");
+    if (sys->rejected > 0) printf("Rejected: %d arrivals found no free PID\n", sys->rejected);
+    if (sys->stalled > 0) printf("Stalled: %d processes lost an event to an out-of-memory heap; the run is incomplete\n", sys->stalled);
+    printf("Simulated time: %ldus | Throughput: %.1f processes/s\n",
+           span, span > 0 ? n * 1e6 / span : 0.0);
+    printf("CPU utilization: %.1f%% | Disk utilization: %.1f%% | Disk I/Os: %ld | Page faults: %ld | Context switches: %ld\n",
+           span > 0 ? 100.0 * sys->cpu_busy / ((double)span * sys->cfg.cores) : 0.0,
+           span > 0 ? 100.0 * sys->disk_busy_time / span : 0.0,
+           sys->disk_ios, sys->page_faults, sys->context_switches);
+    ProcSummary summary;
+    if (n > 0 && procstore_summarize(&sys->finished_procs, &summary) == 0) {
+        procstats_print(&summary, "us");
+        printf("Average I/O wait: %.0fus\n", sys->total_io_wait / n);
+    }
+    printf("Events: %ld in %.3f s wall (%.0f events/s)\n", events, wall_seconds,
+           wall_seconds > 0 ? events / wall_seconds : 0.0);
+}
+
+void procsim_destroy(SimSystem* sys) {
+    for (int i = 0; i < sys->num_procs; i++) {
+        if (sys->procs[i]->pcb != NULL) proctable_exit(sys->table, sys->procs[i]->pid);
+        free(sys->procs[i]);
+    }
+    free(sys->procs);
+    sys->procs = NULL;
+    sys->num_procs = sys->capacity = 0;
+    procstore_free(&sys->finished_procs);
+}
@@ -0,0 +1,73 @@
+#ifndef PROCSIM_H
+#define PROCSIM_H
+
+#include "event.h"
+#include "disk.h"
+#include "memory.h"
+#include "proctable.h"
+#include "procstats.h"
+
+#define SIM_DISK_FCFS     0 // Serve disk requests in arrival order
+#define SIM_DISK_ELEVATOR 1 // One-way elevator; a request that waited disk_expire goes first
+
+typedef struct {
+    char name[50];
+    int pages;       // Pages paged in before the program first runs
+    char file[50];   // File opened between the two compute phases
+    long cpu_time;   // Total compute, in microseconds
+} SimProgram;
+
+typedef struct {
+    int cores;
+    long quantum;         // Round-robin time slice
+    long context_switch;  // Dispatch cost added to every slice
+    int disk_sched;       // SIM_DISK_FCFS or SIM_DISK_ELEVATOR
+    long disk_expire;     // Elevator: a request waiting this long is served next
+    int trace;            // 1 to print every state transition with its simulated time
+} SimConfig;
+
+typedef struct SimProc SimProc;
+
+// Whole-system model: the CPU's ready queue, the pager (memory.c), the file
+// system (filesystem.c) and one disk all advance through timed events.
+typedef struct {
+    SimConfig cfg;
+    EventEngine* engine;
+    ProcTable* table;     // Processes get a PCB and PID here on arrival
+    DiskModel disk;
+    SimProc* ready_head;
+    SimProc* ready_tail;
+    int idle_cores;
+    SimProc* disk_head;   // Processes waiting for the disk, in arrival order
+    SimProc* disk_tail;
+    int disk_busy;
+    int disk_cyl;
+    SimProc** procs;
+    int num_procs;
+    int capacity;
+    int finished;
+    int rejected;         // Arrivals refused because no PID was free
+    int stalled;          // Processes never woken again: their next event could not be posted
+    long start_time;
+    long last_exit;
+    long cpu_busy;
+    long disk_busy_time;
+    long page_faults;
+    long disk_ios;
+    long context_switches;
+    ProcStore finished_procs; // Arrival, CPU time, exit time and ready-queue wait per process
+    double total_io_wait;
+} SimSystem;
+
+void procsim_default_config(SimConfig* cfg);
+void procsim_init(SimSystem* sys, EventEngine* engine, ProcTable* table, const SimConfig* cfg);
+// Starts 'prog' after 'delay'; it is created in the process table when it
+// arrives. Memory and the file system must be initialized.
+int procsim_spawn(SimSystem* sys, const SimProgram* prog, long delay);
+// Runs until every spawned process has terminated. Returns the events fired.
+long procsim_run(SimSystem* sys);
+void procsim_report(const SimSystem* sys, long events, double wall_seconds);
+// Exits any process still in the table and frees the processes.
+void procsim_destroy(SimSystem* sys);
+
+#endif // PROCSIM_H
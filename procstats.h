@@ -0,0 +1,43 @@
+#ifndef PROCSTATS_H
+#define PROCSTATS_H
+
+// Column-oriented record of finished processes: one array per field, so the
+// summary kernels stream through contiguous 64-bit values.
+typedef struct {
+    long n;
+    long capacity;
+    long* arrival;
+    long* burst;
+    long* completion;
+    long* waiting;
+} ProcStore;
+
+typedef struct {
+    double avg;
+    double stddev;
+    long p50;
+    long p95;
+    long p99;
+    long max;
+} ColumnStats;
+
+typedef struct {
+    long n;
+    ColumnStats turnaround;
+    ColumnStats waiting;
+    double fairness; // Jain's index over burst/turnaround; 1.0 when every process progressed at the same rate
+} ProcSummary;
+
+void procstore_init(ProcStore* s);
+void procstore_free(ProcStore* s);
+void procstore_clear(ProcStore* s);
+// Returns -1 when out of memory. Columns grown before the failure stay
+// allocated, so the store must still be released with procstore_free.
+int procstore_reserve(ProcStore* s, long capacity);
+// Returns -1 when out of memory.
+int procstore_add(ProcStore* s, long arrival, long burst, long completion, long waiting);
+// Fills 'out'; returns -1 if the percentile scratch buffer cannot be allocated.
+int procstore_summarize(const ProcStore* s, ProcSummary* out);
+void procstats_print(const ProcSummary* sum, const char* unit);
+
+#endif // PROCSTATS_H
@@ -0,0 +1,163 @@
+/**
+ * proctable.c
+ * Process control block table. PCBs are allocated from chunks and recycled
+ * through a free list; a chained hash on the PID gives O(1) lookup, and PIDs
+ * are handed out in increasing order, wrapping at PID_MAX so the PIDs of
+ * exited processes are reused.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "proctable.h"
+
+#define PROC_CHUNK_SIZE 256
+#define PROC_INITIAL_BUCKETS 64
+
+ProcTable process_table;
+
+static const char* state_names[] = {"NEW", "READY", "RUNNING", "WAITING", "TERMINATED"};
+
+void proctable_init(ProcTable* t) {
+    memset(t, 0, sizeof(*t));
+    t->next_pid = PID_FIRST;
+}
+
+void proctable_destroy(ProcTable* t) {
+    for (int c = 0; c < t->num_chunks; c++) free(t->chunks[c]);
+    free(t->chunks);
+    free(t->buckets);
+    proctable_init(t);
+}
+
+static unsigned int pid_bucket(const ProcTable* t, int pid) {
+    return ((unsigned int)pid * 2654435761u) & (unsigned int)(t->num_buckets - 1);
+}
+
+PCB* proctable_find(const ProcTable* t, int pid) {
+    if (t->num_buckets == 0) return NULL;
+    for (PCB* p = t->buckets[pid_bucket(t, pid)]; p != NULL; p = p->next) {
+        if (p->pid == pid) return p;
+    }
+    return NULL;
+}
+
+static int grow_buckets(ProcTable* t) {
+    int num_buckets = t->num_buckets ? t->num_buckets * 2 : PROC_INITIAL_BUCKETS;
+    PCB** buckets = calloc((size_t)num_buckets, sizeof(PCB*));
+    if (buckets == NULL) return -1;
+    PCB** old = t->buckets;
+    int old_count = t->num_buckets;
+    t->buckets = buckets;
+    t->num_buckets = num_buckets;
+    for (int b = 0; b < old_count; b++) {
+        PCB* p = old[b];
+        while (p != NULL) {
+            PCB* next = p->next;
+            unsigned int slot = pid_bucket(t, p->pid);
+            p->next = buckets[slot];
+            buckets[slot] = p;
+            p = next;
+        }
+    }
+    free(old);
+    return 0;
+}
+
+static int grow_chunks(ProcTable* t) {
+    PCB** chunks = realloc(t->chunks, (size_t)(t->num_chunks + 1) * sizeof(PCB*));
+    if (chunks == NULL) return -1;
+    t->chunks = chunks;
+    PCB* chunk = calloc(PROC_CHUNK_SIZE, sizeof(PCB));
+    if (chunk == NULL) return -1;
+    t->chunks[t->num_chunks++] = chunk;
+    for (int i = PROC_CHUNK_SIZE - 1; i >= 0; i--) {
+        chunk[i].next = t->free_list;
+        t->free_list = &chunk[i];
+    }
+    return 0;
+}
+
+static int in_pid_range(int pid) {
+    return pid >= PID_FIRST && pid < PID_MAX;
+}
+
+static int alloc_pid(ProcTable* t) {
+    if (t->range_count >= PID_MAX - PID_FIRST) return -1;
+    for (int tries = 0; tries < PID_MAX - PID_FIRST; tries++) {
+        int pid = t->next_pid++;
+        if (t->next_pid >= PID_MAX) t->next_pid = PID_FIRST;
+        if (proctable_find(t, pid) == NULL) return pid;
+    }
+    return -1;
+}
+
+PCB* proctable_create(ProcTable* t, int pid, const char* name) {
+    if (pid == 0) {
+        pid = alloc_pid(t);
+        if (pid == -1) return NULL;
+    } else if (pid < 0 || proctable_find(t, pid) != NULL) {
+        return NULL;
+    }
+    if (t->count >= t->num_buckets && grow_buckets(t) != 0) return NULL;
+    if (t->free_list == NULL && grow_chunks(t) != 0) return NULL;
+
+    PCB* p = t->free_list;
+    t->free_list = p->next;
+    memset(p, 0, sizeof(*p));
+    p->pid = pid;
+    p->state = PROC_NEW;
+    strncpy(p->name, name, sizeof(p->name) - 1);
+    p->mem.pid = pid;
+
+    unsigned int slot = pid_bucket(t, pid);
+    p->next = t->buckets[slot];
+    t->buckets[slot] = p;
+    t->count++;
+    if (in_pid_range(pid)) t->range_count++;
+    t->created++;
+    return p;
+}
+
+int proctable_exit(ProcTable* t, int pid) {
+    if (t->num_buckets == 0) return -1;
+    PCB** link = &t->buckets[pid_bucket(t, pid)];
+    while (*link != NULL && (*link)->pid != pid) link = &(*link)->next;
+    PCB* p = *link;
+    if (p == NULL) return -1;
+    *link = p->next;
+    t->count--;
+    if (in_pid_range(pid)) t->range_count--;
+
+    int freed = release_memory(&p->mem);
+    p->pid = 0;
+    p->state = PROC_TERMINATED;
+    p->next = t->free_list;
+    t->free_list = p;
+    t->exited++;
+    return freed;
+}
+
+PCB* proctable_next(const ProcTable* t, int* cursor) {
+    while (*cursor < t->num_chunks * PROC_CHUNK_SIZE) {
+        PCB* p = &t->chunks[*cursor / PROC_CHUNK_SIZE][*cursor % PROC_CHUNK_SIZE];
+        (*cursor)++;
+        if (p->pid != 0) return p;
+    }
+    return NULL;
+}
+
+const char* proctable_state_name(int state) {
+    return state >= PROC_NEW && state <= PROC_TERMINATED ? state_names[state] : "?";
+}
+
+void proctable_print(const ProcTable* t) {
+    printf("\n--- Process Table ---\n");
+    printf("%-8s | %-10s | %-6s | %s\n", "PID", "State", "Pages", "Name");
+    printf("------------------------------------------\n");
+    int cursor = 0;
+    PCB* p;
+    while ((p = proctable_next(t, &cursor)) != NULL) {
+        printf("%-8d | %-10s | %-6d | %s\n", p->pid, proctable_state_name(p->state), p->mem.num_pages_requested, p->name);
+    }
+    printf("Live: %d | Created: %ld | Exited: %ld | Next PID: %d\n", t->count, t->created, t->exited, t->next_pid);
+}
@@ -0,0 +1,57 @@
+#ifndef PROCTABLE_H
+#define PROCTABLE_H
+
+#include "memory.h"
+
+#define PROC_NEW        0
+#define PROC_READY      1
+#define PROC_RUNNING    2
+#define PROC_WAITING    3
+#define PROC_TERMINATED 4
+
+#define PID_FIRST 1001
+#define PID_MAX   32768 // PIDs wrap back to PID_FIRST here, skipping live ones
+
+typedef struct PCB {
+    int pid;              // 0 while the slot is free
+    int state;
+    char name[50];
+    ProcessMemoryInfo mem;
+    struct PCB* next;     // Hash chain, or free list while the slot is free
+} PCB;
+
+// Process control blocks live in fixed chunks, so a PCB never moves once
+// created (the frame map keeps pointers to its page table). Lookup by PID
+// goes through a chained hash that doubles as the table grows.
+typedef struct {
+    PCB** buckets;
+    int num_buckets;
+    PCB** chunks;
+    int num_chunks;
+    PCB* free_list;
+    int count;
+    int range_count;      // Live PIDs within [PID_FIRST, PID_MAX)
+    int next_pid;
+    long created;
+    long exited;
+} ProcTable;
+
+// The shell's process table.
+extern ProcTable process_table;
+
+void proctable_init(ProcTable* t);
+// Frees every PCB without touching frames (use after init_memory_management).
+void proctable_destroy(ProcTable* t);
+// Creates a PCB. pid 0 allocates the next free PID. Returns NULL if the PID
+// is taken, every PID is in use, or memory runs out.
+PCB* proctable_create(ProcTable* t, int pid, const char* name);
+PCB* proctable_find(const ProcTable* t, int pid);
+// Returns the process's frames to the free pool, frees its PCB and makes the
+// PID reusable. Returns the number of frames freed, or -1 for an unknown PID.
+int proctable_exit(ProcTable* t, int pid);
+// Iterates live PCBs: start with *cursor = 0, stops with NULL.
+PCB* proctable_next(const ProcTable* t, int* cursor);
+const char* proctable_state_name(int state);
+void proctable_print(const ProcTable* t);
+
+#endif // PROCTABLE_H
@@ -0,0 +1,590 @@
+/**
+ * raid.c
+ * Multi-device layer on top of the disk request queue.
+ * Logical requests are split into per-device sub-requests for RAID-0, RAID-1
+ * or RAID-5, each device gets its own queue and scheduler, and the devices
+ * are replayed concurrently on host threads. A logical request completes when
+ * the last of its sub-requests does.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "raid.h"
+
+#define RAID_SCALING_LOAD 8 // Arrival-time compression that saturates an array of default disks
+
+typedef struct RaidSync RaidSync;
+
+typedef struct {
+    DiskRequest* reqs;
+    int* parent;       // Logical request each sub-request belongs to
+    int* rmw;          // Read-modify-write it reads for or writes for, -1 if none
+    char* held;        // Set for writes that wait for their read-modify-write's pre-reads
+    long* completion;
+    int count;
+    int capacity;
+    int id;
+    const RaidConfig* cfg;
+    RaidSync* sync;    // NULL when no request depends on another device
+    int* inbox;        // Held writes handed over by other devices, with their arrival
+    long* inbox_at;
+    int inbox_count;
+    int inbox_taken;
+    DiskRunStats stats;
+} DeviceWork;
+
+// One RAID-5 small write to one row: the old data and parity are read, and
+// the data and parity writes are posted when the last of those reads is done.
+typedef struct {
+    int pending;       // Pre-reads still outstanding
+    long ready;        // Latest pre-read completion so far
+    int num_writes;
+    int write_dev[RAID_MAX_DEVICES];
+    int write_index[RAID_MAX_DEVICES];
+} RaidRmw;
+
+// Keeps device threads from running ahead of a hand-over that could still
+// reach them. Each device publishes the earliest time it could still complete
+// a request; no hand-over can arrive before that.
+struct RaidSync {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int num_devices;
+    long lookahead;                // Shortest possible service time
+    long bound[RAID_MAX_DEVICES];
+    DeviceWork* dev;
+    RaidRmw* rmw;
+    int num_rmw;
+    int rmw_capacity;
+};
+
+void raid_default_config(RaidConfig* cfg, int level, int num_devices) {
+    cfg->level = level;
+    cfg->num_devices = num_devices;
+    cfg->stripe_sectors = 128;
+    disk_default_model(&cfg->model);
+    disk_default_queue_config(&cfg->queue, DISK_SCHED_DEADLINE);
+}
+
+static int raid_min_devices(int level) {
+    if (level == RAID_5) return 3;
+    if (level == RAID_1) return 2;
+    return 1;
+}
+
+long raid_logical_sectors(const RaidConfig* cfg) {
+    long device_sectors = (long)cfg->model.total_cylinders * cfg->model.sectors_per_cylinder;
+    long rows = device_sectors / cfg->stripe_sectors;
+    if (cfg->level == RAID_1) return device_sectors;
+    if (cfg->level == RAID_5) return rows * cfg->stripe_sectors * (cfg->num_devices - 1);
+    return rows * cfg->stripe_sectors * cfg->num_devices;
+}
+
+static int device_push(DeviceWork* d, long arrival, long sector, int size, int is_write, int parent,
+                       int rmw, int held) {
+    if (d->count == d->capacity) {
+        int capacity = d->capacity ? d->capacity * 2 : 256;
+        DiskRequest* reqs = realloc(d->reqs, (size_t)capacity * sizeof(DiskRequest));
+        if (reqs == NULL) return -1;
+        d->reqs = reqs;
+        int* parents = realloc(d->parent, (size_t)capacity * sizeof(int));
+        if (parents == NULL) return -1;
+        d->parent = parents;
+        int* rmws = realloc(d->rmw, (size_t)capacity * sizeof(int));
+        if (rmws == NULL) return -1;
+        d->rmw = rmws;
+        char* helds = realloc(d->held, (size_t)capacity);
+        if (helds == NULL) return -1;
+        d->held = helds;
+        d->capacity = capacity;
+    }
+    d->reqs[d->count].arrival_time = arrival;
+    d->reqs[d->count].sector = (int)sector;
+    d->reqs[d->count].size = size;
+    d->reqs[d->count].is_write = is_write;
+    d->parent[d->count] = parent;
+    d->rmw[d->count] = rmw;
+    d->held[d->count] = (char)held;
+    d->count++;
+    return 0;
+}
+
+// Posts a held write of read-modify-write g; the device learns of it when
+// the pre-reads are done.
+static int rmw_push_write(RaidSync* sync, int g, DeviceWork* d, long sector, int size, int parent) {
+    RaidRmw* w = &sync->rmw[g];
+    w->write_dev[w->num_writes] = d->id;
+    w->write_index[w->num_writes] = d->count;
+    w->num_writes++;
+    return device_push(d, 0, sector, size, DISK_WRITE, parent, g, 1);
+}
+
+// Writes 'len' sectors starting 'start' sectors into data row 'row'. A row
+// covered completely gets its parity from the new data alone. Otherwise the
+// old data and parity are read once for the whole row and the data and parity
+// writes wait for those reads.
+static int raid5_write_row(const RaidConfig* cfg, DeviceWork dev[], RaidSync* sync, const DiskRequest* r,
+                           int parent, long row, int start, int len, RaidRunStats* stats) {
+    int n = cfg->num_devices;
+    int stripe = cfg->stripe_sectors;
+    int data_disks = n - 1;
+    int pdev = (n - 1) - (int)(row % n); // Parity rotates one device per row
+    int first = start / stripe;
+    int last = (start + len - 1) / stripe;
+    int err = 0;
+
+    if (start == 0 && len == stripe * data_disks) {
+        for (int k = 0; k < data_disks; k++) {
+            int ddev = (k >= pdev) ? k + 1 : k;
+            err |= device_push(&dev[ddev], r->arrival_time, row * stripe, stripe, DISK_WRITE, parent, -1, 0);
+        }
+        err |= device_push(&dev[pdev], r->arrival_time, row * stripe, stripe, DISK_WRITE, parent, -1, 0);
+        stats->device_ios += data_disks + 1;
+        return err;
+    }
+
+    if (sync->num_rmw == sync->rmw_capacity) {
+        int capacity = sync->rmw_capacity ? sync->rmw_capacity * 2 : 256;
+        RaidRmw* rmw = realloc(sync->rmw, (size_t)capacity * sizeof(RaidRmw));
+        if (rmw == NULL) return -1;
+        sync->rmw = rmw;
+        sync->rmw_capacity = capacity;
+    }
+    int g = sync->num_rmw++;
+    RaidRmw* w = &sync->rmw[g];
+    w->pending = last - first + 2;
+    w->ready = 0;
+    w->num_writes = 0;
+
+    // Parity for every offset any data chunk of the row changes
+    int plo = (first == last) ? start % stripe : 0;
+    int phi = (first == last) ? plo + len : stripe;
+    for (int k = first; k <= last; k++) {
+        int ddev = (k >= pdev) ? k + 1 : k;
+        int lo = (k == first) ? start % stripe : 0;
+        int hi = (k == last) ? (start + len - 1) % stripe + 1 : stripe;
+        err |= device_push(&dev[ddev], r->arrival_time, row * stripe + lo, hi - lo, DISK_READ, parent, g, 0);
+    }
+    err |= device_push(&dev[pdev], r->arrival_time, row * stripe + plo, phi - plo, DISK_READ, parent, g, 0);
+    for (int k = first; k <= last; k++) {
+        int ddev = (k >= pdev) ? k + 1 : k;
+        int lo = (k == first) ? start % stripe : 0;
+        int hi = (k == last) ? (start + len - 1) % stripe + 1 : stripe;
+        err |= rmw_push_write(sync, g, &dev[ddev], row * stripe + lo, hi - lo, parent);
+    }
+    err |= rmw_push_write(sync, g, &dev[pdev], row * stripe + plo, phi - plo, parent);
+    stats->device_ios += 2 * (last - first + 2);
+    return err;
+}
+
+// RAID-1 read balancing: where each mirror's head ends up and when it goes
+// idle once the work mapped to it so far is done. Both are estimated at
+// mapping time, in arrival order; the queues reorder and merge later, so
+// this is not where the head is when the read is actually dispatched.
+typedef struct {
+    int last_cyl;
+    long free_at;
+} MirrorHint;
+
+static void mirror_note(const RaidConfig* cfg, MirrorHint* m, const DiskRequest* r) {
+    if (r->arrival_time > m->free_at) m->free_at = r->arrival_time;
+    m->free_at += disk_service_time(&cfg->model, m->last_cyl, r->sector, r->size);
+    m->last_cyl = (r->sector + r->size - 1) / cfg->model.sectors_per_cylinder;
+}
+
+// Splits one logical request into device sub-requests.
+static int raid_map_request(const RaidConfig* cfg, DeviceWork dev[], RaidSync* sync, MirrorHint mirror[],
+                            const DiskRequest* r, int parent, RaidRunStats* stats) {
+    int n = cfg->num_devices;
+    int stripe = cfg->stripe_sectors;
+    int spc = cfg->model.sectors_per_cylinder;
+    long lsec = r->sector;
+    int left = r->size;
+    int err = 0;
+
+    if (cfg->level == RAID_1) {
+        if (r->is_write) {
+            for (int d = 0; d < n; d++) {
+                err |= device_push(&dev[d], r->arrival_time, lsec, left, DISK_WRITE, parent, -1, 0);
+                mirror_note(cfg, &mirror[d], r);
+            }
+        } else {
+            // Nearest head; on a tie (every write leaves the mirrors level)
+            // the mirror with the least queued work
+            int best = 0;
+            int cyl = (int)(lsec / spc);
+            for (int d = 1; d < n; d++) {
+                int dist = abs(cyl - mirror[d].last_cyl);
+                int best_dist = abs(cyl - mirror[best].last_cyl);
+                if (dist < best_dist || (dist == best_dist && mirror[d].free_at < mirror[best].free_at)) best = d;
+            }
+            err |= device_push(&dev[best], r->arrival_time, lsec, left, DISK_READ, parent, -1, 0);
+            mirror_note(cfg, &mirror[best], r);
+        }
+        stats->device_ios += r->is_write ? n : 1;
+        return err;
+    }
+
+    int data_disks = (cfg->level == RAID_5) ? n - 1 : n;
+    long row_sectors = (long)stripe * data_disks;
+
+    if (cfg->level == RAID_5 && r->is_write) {
+        if (lsec % row_sectors == 0 && r->size % row_sectors == 0) stats->full_stripe_writes++;
+        else stats->rmw_writes++;
+        // Parity is kept per row, so writes go a row at a time
+        while (left > 0 && !err) {
+            long row = lsec / row_sectors;
+            int start = (int)(lsec - row * row_sectors);
+            int len = (left < row_sectors - start) ? left : (int)(row_sectors - start);
+            err |= raid5_write_row(cfg, dev, sync, r, parent, row, start, len, stats);
+            lsec += len;
+            left -= len;
+        }
+        return err;
+    }
+
+    while (left > 0) {
+        long chunk = lsec / stripe;
+        int off = (int)(lsec % stripe);
+        int len = (left < stripe - off) ? left : stripe - off;
+
+        if (cfg->level == RAID_0) {
+            long dsec = (chunk / n) * stripe + off;
+            err |= device_push(&dev[chunk % n], r->arrival_time, dsec, len, r->is_write, parent, -1, 0);
+        } else {
+            long row = chunk / data_disks;
+            int k = (int)(chunk % data_disks);
+            int pdev = (n - 1) - (int)(row % n);
+            int ddev = (k >= pdev) ? k + 1 : k;
+            err |= device_push(&dev[ddev], r->arrival_time, row * stripe + off, len, DISK_READ, parent, -1, 0);
+        }
+        stats->device_ios++;
+        lsec += len;
+        left -= len;
+    }
+    return err;
+}
+
+static int link_take(void* ctx, int* index, long* arrival) {
+    DeviceWork* d = ctx;
+    pthread_mutex_lock(&d->sync->lock);
+    int ok = d->inbox_taken < d->inbox_count;
+    if (ok) {
+        *index = d->inbox[d->inbox_taken];
+        *arrival = d->inbox_at[d->inbox_taken];
+        d->inbox_taken++;
+    }
+    pthread_mutex_unlock(&d->sync->lock);
+    return ok;
+}
+
+// Earliest time any other device could still hand 'self' a request. A device
+// can also be woken by a hand-over itself, which comes no sooner than the
+// lowest bound of all, and then needs at least one service time to finish.
+static long sync_safe_time(const RaidSync* s, int self) {
+    long low = DISK_TIME_NEVER;
+    for (int e = 0; e < s->num_devices; e++) {
+        if (s->bound[e] < low) low = s->bound[e];
+    }
+    long safe = (low == DISK_TIME_NEVER) ? low : low + s->lookahead;
+    for (int e = 0; e < s->num_devices; e++) {
+        if (e != self && s->bound[e] < safe) safe = s->bound[e];
+    }
+    return safe;
+}
+
+static int link_wait(void* ctx, long t, int finishing, long bound) {
+    DeviceWork* d = ctx;
+    RaidSync* s = d->sync;
+    int ok = 0;
+    pthread_mutex_lock(&s->lock);
+    // Unseen hand-overs would make the bound wrong; collect them first
+    if (d->inbox_taken == d->inbox_count) {
+        if (s->bound[d->id] != bound) {
+            s->bound[d->id] = bound;
+            pthread_cond_broadcast(&s->changed);
+        }
+        while (d->inbox_taken == d->inbox_count) {
+            long safe = sync_safe_time(s, d->id);
+            // Completions at t may go as soon as nothing can arrive before t;
+            // arrivals and dispatches at t wait until every completion at t is in.
+            if (t == DISK_TIME_NEVER ? safe == DISK_TIME_NEVER : (finishing ? t <= safe : t < safe)) {
+                ok = 1;
+                break;
+            }
+            pthread_cond_wait(&s->changed, &s->lock);
+        }
+    }
+    pthread_mutex_unlock(&s->lock);
+    return ok;
+}
+
+static void link_complete(void* ctx, int index, long t) {
+    DeviceWork* d = ctx;
+    int g = d->rmw[index];
+    if (g < 0 || d->held[index]) return;
+    RaidSync* s = d->sync;
+    pthread_mutex_lock(&s->lock);
+    RaidRmw* w = &s->rmw[g];
+    if (t > w->ready) w->ready = t;
+    if (--w->pending == 0) {
+        for (int k = 0; k < w->num_writes; k++) {
+            DeviceWork* to = &s->dev[w->write_dev[k]];
+            to->inbox[to->inbox_count] = w->write_index[k];
+            to->inbox_at[to->inbox_count] = w->ready;
+            to->inbox_count++;
+            if (w->ready + s->lookahead < s->bound[to->id]) s->bound[to->id] = w->ready + s->lookahead;
+        }
+        pthread_cond_broadcast(&s->changed);
+    }
+    pthread_mutex_unlock(&s->lock);
+}
+
+static void* device_thread(void* arg) {
+    DeviceWork* d = arg;
+    if (d->sync == NULL) {
+        disk_replay(d->reqs, d->count, 0, &d->cfg->model, &d->cfg->queue, &d->stats, d->completion, NULL, NULL);
+        return NULL;
+    }
+    DiskLink link = {d, d->held, link_take, link_wait, link_complete};
+    disk_replay_linked(d->reqs, d->count, 0, &d->cfg->model, &d->cfg->queue, &d->stats, d->completion,
+                       NULL, NULL, &link);
+    pthread_mutex_lock(&d->sync->lock);
+    d->sync->bound[d->id] = DISK_TIME_NEVER;
+    pthread_cond_broadcast(&d->sync->changed);
+    pthread_mutex_unlock(&d->sync->lock);
+    return NULL;
+}
+
+// Prints why the level or device count cannot be simulated and returns -1.
+static int raid_check_config(const RaidConfig* cfg) {
+    if (cfg->level != RAID_0 && cfg->level != RAID_1 && cfg->level != RAID_5) {
+        printf("Unsupported RAID level %d (use 0, 1 or 5).\n", cfg->level);
+        return -1;
+    }
+    if (cfg->num_devices < raid_min_devices(cfg->level) || cfg->num_devices > RAID_MAX_DEVICES) {
+        printf("RAID-%d needs between %d and %d devices.\n", cfg->level, raid_min_devices(cfg->level), RAID_MAX_DEVICES);
+        return -1;
+    }
+    return 0;
+}
+
+int raid_replay(const RaidConfig* cfg, const DiskRequest trace[], int n, RaidRunStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (raid_check_config(cfg) != 0) return -1;
+
+    DeviceWork dev[RAID_MAX_DEVICES];
+    pthread_t threads[RAID_MAX_DEVICES];
+    MirrorHint mirror[RAID_MAX_DEVICES];
+    RaidSync sync;
+    memset(dev, 0, sizeof(dev));
+    memset(&sync, 0, sizeof(sync));
+    sync.num_devices = cfg->num_devices;
+    sync.dev = dev;
+    for (int d = 0; d < cfg->num_devices; d++) {
+        dev[d].cfg = cfg;
+        dev[d].id = d;
+        mirror[d].last_cyl = 0;
+        mirror[d].free_at = 0;
+    }
+
+    long capacity = raid_logical_sectors(cfg);
+    long* logical_done = malloc((size_t)(n > 0 ? n : 1) * sizeof(long));
+    int err = (logical_done == NULL);
+    for (int i = 0; i < n && !err; i++) {
+        logical_done[i] = -1;
+        if (trace[i].size <= 0 || trace[i].sector < 0 || trace[i].sector + (long)trace[i].size > capacity) continue;
+        stats->requests++;
+        stats->logical_sectors += trace[i].size;
+        if (trace[i].is_write) stats->writes++;
+        else stats->reads++;
+        err = raid_map_request(cfg, dev, &sync, mirror, &trace[i], i, stats);
+    }
+    for (int d = 0; d < cfg->num_devices && !err; d++) {
+        size_t count = (size_t)(dev[d].count > 0 ? dev[d].count : 1);
+        dev[d].completion = malloc(count * sizeof(long));
+        if (dev[d].completion == NULL) err = 1;
+        if (sync.num_rmw > 0) {
+            dev[d].inbox = malloc(count * sizeof(int));
+            dev[d].inbox_at = malloc(count * sizeof(long));
+            if (dev[d].inbox == NULL || dev[d].inbox_at == NULL) err = 1;
+            dev[d].sync = &sync;
+        }
+    }
+
+    // Read-modify-writes tie the devices together; without any they run freely
+    int linked = (sync.num_rmw > 0 && !err);
+    if (linked) {
+        long lookahead = disk_service_time(&cfg->model, 0, 0, 1);
+        sync.lookahead = lookahead > 0 ? lookahead : 1;
+        pthread_mutex_init(&sync.lock, NULL);
+        pthread_cond_init(&sync.changed, NULL);
+    }
+    int started = 0;
+    if (!err) {
+        for (; started < cfg->num_devices; started++) {
+            if (pthread_create(&threads[started], NULL, device_thread, &dev[started]) != 0) {
+                err = 1;
+                break;
+            }
+        }
+        if (linked && started < cfg->num_devices) {
+            // Devices that never started must not hold the others back
+            pthread_mutex_lock(&sync.lock);
+            for (int d = started; d < cfg->num_devices; d++) sync.bound[d] = DISK_TIME_NEVER;
+            pthread_cond_broadcast(&sync.changed);
+            pthread_mutex_unlock(&sync.lock);
+        }
+        for (int d = 0; d < started; d++) pthread_join(threads[d], NULL);
+    }
+    if (linked) {
+        pthread_mutex_destroy(&sync.lock);
+        pthread_cond_destroy(&sync.changed);
+    }
+
+    if (!err) {
+        for (int d = 0; d < cfg->num_devices; d++) {
+            stats->device[d] = dev[d].stats;
+            if (dev[d].stats.makespan > stats->makespan) stats->makespan = dev[d].stats.makespan;
+            for (int j = 0; j < dev[d].count; j++) {
+                int p = dev[d].parent[j];
+                if (dev[d].completion[j] > logical_done[p]) logical_done[p] = dev[d].completion[j];
+            }
+        }
+        for (int d = 0; d < cfg->num_devices; d++) {
+            stats->utilization[d] = stats->makespan > 0 ? (double)dev[d].stats.busy_time / stats->makespan : 0;
+        }
+        if (stats->makespan > 0) {
+            double secs = stats->makespan / 1e6;
+            stats->iops = stats->requests / secs;
+            stats->mb_per_sec = stats->logical_sectors * (double)RAID_SECTOR_BYTES / 1e6 / secs;
+        }
+
+        long* read_lat = malloc((size_t)(stats->reads + 1) * sizeof(long));
+        long* write_lat = malloc((size_t)(stats->writes + 1) * sizeof(long));
+        if (read_lat && write_lat) {
+            int nr = 0, nw = 0;
+            double unused_p95;
+            long unused_max;
+            for (int i = 0; i < n; i++) {
+                if (logical_done[i] < 0) continue;
+                if (trace[i].is_write) write_lat[nw++] = logical_done[i] - trace[i].arrival_time;
+                else read_lat[nr++] = logical_done[i] - trace[i].arrival_time;
+            }
+            disk_latency_summary(read_lat, nr, &stats->read_avg_latency, &unused_p95, &stats->read_p99_latency, &unused_max);
+            disk_latency_summary(write_lat, nw, &stats->write_avg_latency, &unused_p95, &stats->write_p99_latency, &unused_max);
+        }
+        free(read_lat);
+        free(write_lat);
+    } else {
+        printf("RAID replay: out of resources for %d requests.\n", n);
+    }
+
+    for (int d = 0; d < cfg->num_devices; d++) {
+        free(dev[d].reqs);
+        free(dev[d].parent);
+        free(dev[d].rmw);
+        free(dev[d].held);
+        free(dev[d].completion);
+        free(dev[d].inbox);
+        free(dev[d].inbox_at);
+    }
+    free(sync.rmw);
+    free(logical_done);
+    return err ? -1 : 0;
+}
+
+static DiskRequest* raid_make_trace(const RaidConfig* cfg, int n, unsigned int seed, int load) {
+    DiskRequest* trace = malloc((size_t)n * sizeof(DiskRequest));
+    if (trace == NULL) return NULL;
+    DiskModel logical = cfg->model;
+    logical.total_cylinders = (int)(raid_logical_sectors(cfg) / cfg->model.sectors_per_cylinder);
+    if (disk_generate_trace(trace, n, seed, &logical) != 0) {
+        printf("Logical capacity is too small for a generated trace.\n");
+        free(trace);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) trace[i].arrival_time /= load;
+    return trace;
+}
+
+// Faster devices need proportionally denser arrivals to stay saturated.
+static int raid_saturating_load(const RaidConfig* cfg) {
+    DiskModel hdd;
+    disk_default_model(&hdd);
+    int mid = hdd.total_cylinders / 2 * hdd.sectors_per_cylinder;
+    long hdd_cost = disk_service_time(&hdd, 0, mid, 8);
+    long cost = disk_service_time(&cfg->model, 0, mid, 8);
+    return (int)(RAID_SCALING_LOAD * hdd_cost / (cost > 0 ? cost : 1));
+}
+
+static void raid_setup(RaidConfig* cfg, int level, int num_devices, int ssd) {
+    raid_default_config(cfg, level, num_devices);
+    if (ssd) disk_ssd_model(&cfg->model);
+}
+
+void simulate_raid(int level, int num_devices, int ssd, int n, unsigned int seed) {
+    printf("\n## RAID-%d Simulation (%d x %s) ##\n", level, num_devices, ssd ? "SSD" : "HDD");
+    if (n <= 0) {
+        printf("No disk requests to process.\n");
+        return;
+    }
+    RaidConfig cfg;
+    raid_setup(&cfg, level, num_devices, ssd);
+    if (raid_check_config(&cfg) != 0) return;
+    DiskRequest* trace = raid_make_trace(&cfg, n, seed, 1);
+    RaidRunStats s;
+    if (trace == NULL || raid_replay(&cfg, trace, n, &s) != 0) {
+        free(trace);
+        return;
+    }
+    printf("Stripe: %d sectors | Logical capacity: %ld sectors | Requests: %d (reads %d, writes %d)\n",
+           cfg.stripe_sectors, raid_logical_sectors(&cfg), s.requests, s.reads, s.writes);
+    if (level == RAID_5) {
+        printf("Writes: %d read-modify-write, %d full-stripe\n", s.rmw_writes, s.full_stripe_writes);
+    }
+    printf("Device I/Os: %ld (%.2f per logical request)\n", s.device_ios,
+           s.requests > 0 ? (double)s.device_ios / s.requests : 0.0);
+    printf("\nDev\tIOs\tDispatched\tHeadMove\tBusy(us)\tUtil\n");
+    for (int d = 0; d < num_devices; d++) {
+        const DiskRunStats* ds = &s.device[d];
+        printf("%d\t%d\t%d\t\t%ld\t\t%ld\t%.1f%%\n", d, ds->requests, ds->dispatched,
+               ds->head_movement, ds->busy_time, s.utilization[d] * 100);
+    }
+    printf("\nMakespan: %ld us | Throughput: %.1f IOPS, %.2f MB/s\n", s.makespan, s.iops, s.mb_per_sec);
+    printf("Read latency  (us): avg %.0f, p99 %.0f\n", s.read_avg_latency, s.read_p99_latency);
+    printf("Write latency (us): avg %.0f, p99 %.0f\n", s.write_avg_latency, s.write_p99_latency);
+    free(trace);
+}
+
+void simulate_raid_scaling(int level, int max_devices, int ssd, int n, unsigned int seed) {
+    printf("\n## RAID-%d Scaling (%s, saturating load) ##\n", level, ssd ? "SSD" : "HDD");
+    RaidConfig check;
+    raid_setup(&check, level, raid_min_devices(level), ssd);
+    if (raid_check_config(&check) != 0) return;
+    int min = raid_min_devices(level);
+    if (max_devices < min || max_devices > RAID_MAX_DEVICES || n <= 0) {
+        printf("Device count must be between %d and %d, request count positive.\n", min, RAID_MAX_DEVICES);
+        return;
+    }
+    printf("Devices\tIOPS\t\tMB/s\tSpeedup\tAvgUtil\tRead p99(us)\tWrite p99(us)\n");
+    double base_iops = 0;
+    for (int devices = min; devices <= max_devices; devices++) {
+        RaidConfig cfg;
+        raid_setup(&cfg, level, devices, ssd);
+        DiskRequest* trace = raid_make_trace(&cfg, n, seed, raid_saturating_load(&cfg));
+        RaidRunStats s;
+        if (trace == NULL || raid_replay(&cfg, trace, n, &s) != 0) {
+            free(trace);
+            return;
+        }
+        double util = 0;
+        for (int d = 0; d < devices; d++) util += s.utilization[d];
+        util /= devices;
+        if (devices == min) base_iops = s.iops;
+        printf("%d\t%-10.1f\t%.2f\t%.2fx\t%.1f%%\t%.0f\t\t%.0f\n", devices, s.iops, s.mb_per_sec,
+               base_iops > 0 ? s.iops / base_iops : 0.0, util * 100, s.read_p99_latency, s.write_p99_latency);
+        free(trace);
+    }
+}
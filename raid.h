@@ -0,0 +1,48 @@
+#ifndef RAID_H
+#define RAID_H
+
+#include "disk.h"
+
+#define RAID_0 0 // Striping
+#define RAID_1 1 // Mirroring, reads go to the mirror whose head is nearest, ties to the less loaded one
+#define RAID_5 5 // Striping with rotating parity, small writes pay read-modify-write
+
+#define RAID_MAX_DEVICES 16
+#define RAID_SECTOR_BYTES 512
+
+typedef struct {
+    int level;
+    int num_devices;
+    int stripe_sectors;    // Chunk size written to one device before moving to the next
+    DiskModel model;       // Every member device uses the same model
+    DiskQueueConfig queue; // ...and its own queue with this configuration
+} RaidConfig;
+
+typedef struct {
+    int requests;
+    int reads;
+    int writes;
+    int full_stripe_writes; // RAID-5 writes that covered whole rows and skipped the pre-reads
+    int rmw_writes;         // RAID-5 writes that paid the read-modify-write penalty
+    long device_ios;        // Sub-requests sent to member devices
+    long logical_sectors;
+    long makespan;
+    double iops;
+    double mb_per_sec;
+    double read_avg_latency, read_p99_latency;
+    double write_avg_latency, write_p99_latency;
+    DiskRunStats device[RAID_MAX_DEVICES];
+    double utilization[RAID_MAX_DEVICES]; // Busy time / makespan, per device
+} RaidRunStats;
+
+void raid_default_config(RaidConfig* cfg, int level, int num_devices);
+long raid_logical_sectors(const RaidConfig* cfg);
+
+// Splits each logical request over the member devices and replays every
+// device's queue on its own host thread. Returns 0 on success.
+int raid_replay(const RaidConfig* cfg, const DiskRequest trace[], int n, RaidRunStats* stats);
+
+void simulate_raid(int level, int num_devices, int ssd, int n, unsigned int seed);
+void simulate_raid_scaling(int level, int max_devices, int ssd, int n, unsigned int seed);
+
+#endif // RAID_H
@@ -1,11 +1,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "scheduler.h"
+#include "simlog.h"
+#include "metrics.h"
+#include "procstats.h"
 
 void simulate_round_robin(Process processes[], int n, int time_quantum) {
-    printf("\n--  Round Robin Scheduling Simulation --\n");
-    printf("Time Quantum: %d\n", time_quantum);
-    printf("PID\tArrival\tBurst\tCompletion\tTurnaround\tWaiting\n");
+    SIM_LOG("\n--  Round Robin Scheduling Simulation --\n");
+    SIM_LOG("Time Quantum: %d\n", time_quantum);
+    SIM_LOG("PID\tArrival\tBurst\tCompletion\tTurnaround\tWaiting\n");
 
     int current_time = 0;
     int completed_processes = 0;
@@ -28,7 +31,7 @@ void simulate_round_robin(Process processes[], int n, int time_quantum) {
             if (processes[i].arrival_time <= current_time && processes[i].remaining_time > 0 && !processes[i].in_queue) {
                 if (rear == MAX_PROCESSES - 1 && front == 0 || rear + 1 == front) { // Queue full check for circular array
                     // This shouldn't happen if MAX_PROCESSES is sufficient
-                    printf("Error: Ready queue is full!\n");
+                    SIM_LOG("Error: Ready queue is full!\n");
                 } else {
                     if (front == -1) front = 0; // First element
                     rear = (rear + 1) % MAX_PROCESSES;
@@ -56,7 +59,7 @@ void simulate_round_robin(Process processes[], int n, int time_quantum) {
                     }
                 }
                 if(min_next_arrival != -1 && min_next_arrival > current_time) {
-                    printf("CPU Idle. Advancing time from %d to %d\n", current_time, min_next_arrival);
+                    SIM_LOG("CPU Idle. Advancing time from %d to %d\n", current_time, min_next_arrival);
                     current_time = min_next_arrival;
                 } else {
                      current_time++; // Default advance if no specific next arrival found or it's in past/present
@@ -74,7 +77,8 @@ void simulate_round_robin(Process processes[], int n, int time_quantum) {
         
         processes[current_process_idx].in_queue = 0; // Mark as dequeued for execution
 
-        printf("Time %d: Executing Process PID %d (Burst left: %d)\n", current_time, processes[current_process_idx].pid, processes[current_process_idx].remaining_time);
+        metric_inc(&metric_sched_context_switches);
+        SIM_LOG("Time %d: Executing Process PID %d (Burst left: %d)\n", current_time, processes[current_process_idx].pid, processes[current_process_idx].remaining_time);
 
         if (processes[current_process_idx].remaining_time <= time_quantum) {
             current_time += processes[current_process_idx].remaining_time;
@@ -83,8 +87,11 @@ void simulate_round_robin(Process processes[], int n, int time_quantum) {
             processes[current_process_idx].turnaround_time = processes[current_process_idx].completion_time - processes[current_process_idx].arrival_time;
             processes[current_process_idx].waiting_time = processes[current_process_idx].turnaround_time - processes[current_process_idx].burst_time;
             completed_processes++;
+            metric_inc(&metric_sched_completed);
+            metric_observe(&metric_sched_waiting_time, processes[current_process_idx].waiting_time);
+            metric_observe(&metric_sched_turnaround_time, processes[current_process_idx].turnaround_time);
 
-            printf("Time %d: Process PID %d FINISHED. CT=%d, TAT=%d, WT=%d\n",
+            SIM_LOG("Time %d: Process PID %d FINISHED. CT=%d, TAT=%d, WT=%d\n",
                    current_time,
                    processes[current_process_idx].pid,
                    processes[current_process_idx].completion_time,
@@ -93,7 +100,7 @@ void simulate_round_robin(Process processes[], int n, int time_quantum) {
         } else {
             current_time += time_quantum;
             processes[current_process_idx].remaining_time -= time_quantum;
-            printf("Time %d: Process PID %d ran for quantum. Remaining: %d\n", current_time, processes[current_process_idx].pid, processes[current_process_idx].remaining_time);
+            SIM_LOG("Time %d: Process PID %d ran for quantum. Remaining: %d\n", current_time, processes[current_process_idx].pid, processes[current_process_idx].remaining_time);
             
             // Add processes that might have arrived during this quantum's execution before adding current one back
              for (i = 0; i < n; i++) {
@@ -120,20 +127,31 @@ void simulate_round_robin(Process processes[], int n, int time_quantum) {
         }
     }
 
-    printf("\nFinal Process States:\n");
-    printf("PID\tArrival\tBurst\tCompletion\tTurnaround\tWaiting\n");
-    float avg_turnaround_time = 0, avg_waiting_time = 0;
+    SIM_LOG("\nFinal Process States:\n");
+    SIM_LOG("PID\tArrival\tBurst\tCompletion\tTurnaround\tWaiting\n");
     for (i = 0; i < n; i++) {
-        printf("%d\t%d\t%d\t%d\t\t%d\t\t%d\n",
+        SIM_LOG("%d\t%d\t%d\t%d\t\t%d\t\t%d\n",
                processes[i].pid, processes[i].arrival_time, processes[i].burst_time,
                processes[i].completion_time, processes[i].turnaround_time, processes[i].waiting_time);
-        avg_turnaround_time += processes[i].turnaround_time;
-        avg_waiting_time += processes[i].waiting_time;
     }
-    if (n > 0) {
-        avg_turnaround_time /= n;
-        avg_waiting_time /= n;
+    if (!sim_verbose || n <= 0) return;
+
+    ProcStore store;
+    ProcSummary summary;
+    procstore_init(&store);
+    if (procstore_reserve(&store, n) != 0) {
+        printf("Error: out of memory for the run summary.\n");
+        procstore_free(&store);
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        procstore_add(&store, processes[i].arrival_time, processes[i].burst_time,
+                      processes[i].completion_time, processes[i].waiting_time);
+    }
+    if (procstore_summarize(&store, &summary) == 0) {
+        printf("\nAverage Turnaround Time: %.2f\n", summary.turnaround.avg);
+        printf("Average Waiting Time: %.2f\n", summary.waiting.avg);
+        procstats_print(&summary, "");
     }
-    printf("\nAverage Turnaround Time: %.2f\n", avg_turnaround_time);
-    printf("Average Waiting Time: %.2f\n", avg_waiting_time);
+    procstore_free(&store);
 }
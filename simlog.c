@@ -0,0 +1,3 @@
+#include "simlog.h"
+
+int sim_verbose = 1;
@@ -0,0 +1,12 @@
+#ifndef SIMLOG_H
+#define SIMLOG_H
+
+#include <stdio.h>
+
+// Step-by-step simulator narration. Benchmarks and sweeps turn it off so
+// they measure the simulation rather than the terminal.
+extern int sim_verbose;
+
+#define SIM_LOG(...) do { if (sim_verbose) printf(__VA_ARGS__); } while (0)
+
+#endif // SIMLOG_H
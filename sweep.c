@@ -0,0 +1,306 @@
+/**
+ * sweep.c
+ * Parameter sweeps over the full-system simulation. Every combination of
+ * time quantum, frame count, core count and disk algorithm is run
+ * independently on the work-stealing pool; each run has its own memory,
+ * file system, process table and event engine. Replica r of every
+ * configuration sees the same seeded arrivals, so configurations are
+ * compared on identical workloads and the CSV is identical for any
+ * thread count.
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sweep.h"
+#include "filesystem.h"
+#include "workload.h"
+#include "threadpool.h"
+#include "metrics.h"
+#include "simlog.h"
+
+typedef struct {
+    long quantum;
+    long frames;
+    long cores;
+    int disk;
+    int replica;
+    unsigned long long seed;
+    int finished;
+    int rejected;
+    int stalled;
+    long makespan;
+    double throughput;
+    double cpu_util;
+    double disk_util;
+    long page_faults;
+    long disk_ios;
+    long context_switches;
+    long events;
+    ProcSummary summary;
+} SweepResult;
+
+typedef struct {
+    const SweepConfig* cfg;
+    SweepResult* results;
+    long num_quantum, num_frames, num_cores;
+} Sweep;
+
+void sweep_default_config(SweepConfig* cfg, const SimProgram* programs, int num_programs) {
+    SimConfig sim;
+    procsim_default_config(&sim);
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->quantum = (SweepRange){sim.quantum, sim.quantum, 1, 0};
+    cfg->frames = (SweepRange){NUM_FRAMES, NUM_FRAMES, 1, 0};
+    cfg->cores = (SweepRange){sim.cores, sim.cores, 1, 0};
+    cfg->disks[0] = SIM_DISK_FCFS;
+    cfg->num_disks = 1;
+    cfg->replicas = 1;
+    cfg->processes = 200;
+    cfg->mean_gap = 200000;
+    cfg->workload = WORKLOAD_UNIFORM;
+    cfg->seed = 1;
+    cfg->threads = threadpool_default_threads();
+    cfg->programs = programs;
+    cfg->num_programs = num_programs;
+}
+
+int sweep_parse_range(const char* text, SweepRange* r) {
+    char* end;
+    r->lo = strtol(text, &end, 10);
+    r->hi = r->lo;
+    r->step = 1;
+    r->geometric = 0;
+    if (end == text) return -1;
+    if (*end == '\0') return 0;
+    if (strncmp(end, "..", 2) != 0) return -1;
+    const char* p = end + 2;
+    r->hi = strtol(p, &end, 10);
+    if (end == p) return -1;
+    if (*end == ':' || *end == '*') {
+        r->geometric = (*end == '*');
+        p = end + 1;
+        r->step = strtol(p, &end, 10);
+        if (end == p) return -1;
+    }
+    if (*end != '\0' || r->hi < r->lo) return -1;
+    if (r->geometric ? (r->step < 2 || r->lo < 1) : r->step < 1) return -1;
+    if (sweep_range_count(r) > SWEEP_MAX_RUNS) return -1;
+    return 0;
+}
+
+long sweep_range_count(const SweepRange* r) {
+    if (!r->geometric) {
+        // hi - lo can exceed LONG_MAX when lo is negative
+        unsigned long steps = ((unsigned long)r->hi - (unsigned long)r->lo) / (unsigned long)r->step;
+        return steps >= (unsigned long)LONG_MAX ? LONG_MAX : (long)steps + 1;
+    }
+    long count = 1;
+    for (long v = r->lo; v <= r->hi / r->step; v *= r->step) count++;
+    return count;
+}
+
+static long range_value(const SweepRange* r, long i) {
+    if (!r->geometric) return r->lo + i * r->step;
+    long v = r->lo;
+    while (i-- > 0 && v <= r->hi / r->step) v *= r->step;
+    return v;
+}
+
+long sweep_total_runs(const SweepConfig* cfg) {
+    long factors[] = {sweep_range_count(&cfg->quantum), sweep_range_count(&cfg->frames),
+                      sweep_range_count(&cfg->cores), cfg->num_disks, cfg->replicas};
+    long total = 1;
+    for (int i = 0; i < (int)(sizeof(factors) / sizeof(factors[0])); i++) {
+        if (factors[i] <= 0) return 0;
+        if (factors[i] > SWEEP_MAX_RUNS / total) return -1;
+        total *= factors[i];
+    }
+    return total;
+}
+
+static unsigned long long splitmix64(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static const char* disk_name(int sched) {
+    return sched == SIM_DISK_ELEVATOR ? "elevator" : "fcfs";
+}
+
+// Run index -> configuration. Replicas vary fastest, then disk, cores,
+// frames and quantum.
+static void decode_run(const Sweep* s, long run, SweepResult* r) {
+    const SweepConfig* cfg = s->cfg;
+    r->replica = (int)(run % cfg->replicas);
+    run /= cfg->replicas;
+    r->disk = cfg->disks[run % cfg->num_disks];
+    run /= cfg->num_disks;
+    r->cores = range_value(&cfg->cores, run % s->num_cores);
+    run /= s->num_cores;
+    r->frames = range_value(&cfg->frames, run % s->num_frames);
+    run /= s->num_frames;
+    r->quantum = range_value(&cfg->quantum, run);
+    r->seed = splitmix64(cfg->seed + (unsigned long long)r->replica);
+}
+
+static void sweep_task(void* ctx, long run, int worker) {
+    Sweep* s = ctx;
+    const SweepConfig* cfg = s->cfg;
+    SweepResult* r = &s->results[run];
+    decode_run(s, run, r);
+
+    // Private instances of everything the simulation touches
+    metrics_enabled = 0;
+    MemoryState mem;
+    FileSystemState fs;
+    MemoryState* saved_mem = mem_state;
+    FileSystemState* saved_fs = fs_state;
+    mem_state = &mem;
+    fs_state = &fs;
+    init_memory_frames((int)r->frames);
+    init_filesystem();
+    EventEngine engine;
+    event_engine_init(&engine);
+    ProcTable table;
+    proctable_init(&table);
+
+    SimConfig sim;
+    procsim_default_config(&sim);
+    sim.quantum = r->quantum;
+    sim.cores = (int)r->cores;
+    sim.disk_sched = r->disk;
+    SimSystem sys;
+    procsim_init(&sys, &engine, &table, &sim);
+
+    Workload w;
+    workload_init(&w, cfg->workload, cfg->num_programs, r->seed);
+    long arrival = 0;
+    for (int i = 0; i < cfg->processes; i++) {
+        arrival += workload_next_gap(&w, cfg->mean_gap);
+        if (procsim_spawn(&sys, &cfg->programs[workload_next_key(&w)], arrival) != 0) break;
+    }
+    r->events = procsim_run(&sys);
+
+    long span = sys.last_exit - sys.start_time;
+    r->finished = sys.finished;
+    r->rejected = sys.rejected;
+    r->stalled = sys.stalled;
+    r->makespan = span;
+    r->throughput = span > 0 ? sys.finished * 1e6 / span : 0.0;
+    r->cpu_util = span > 0 ? (double)sys.cpu_busy / ((double)span * sys.cfg.cores) : 0.0;
+    r->disk_util = span > 0 ? (double)sys.disk_busy_time / span : 0.0;
+    r->page_faults = sys.page_faults;
+    r->disk_ios = sys.disk_ios;
+    r->context_switches = sys.context_switches;
+    procstore_summarize(&sys.finished_procs, &r->summary);
+
+    procsim_destroy(&sys);
+    proctable_destroy(&table);
+    event_engine_destroy(&engine);
+    mem_state = saved_mem;
+    fs_state = saved_fs;
+}
+
+static void write_csv(FILE* out, const SweepResult* results, long n) {
+    fprintf(out, "run,replica,seed,quantum_us,frames,cores,disk,finished,rejected,stalled,makespan_us,"
+                 "throughput_per_s,cpu_util,disk_util,page_faults,disk_ios,context_switches,events,"
+                 "turnaround_avg_us,turnaround_stddev_us,turnaround_p50_us,turnaround_p95_us,turnaround_p99_us,"
+                 "turnaround_max_us,waiting_avg_us,waiting_p50_us,waiting_p95_us,waiting_p99_us,fairness\n");
+    for (long i = 0; i < n; i++) {
+        const SweepResult* r = &results[i];
+        const ColumnStats* t = &r->summary.turnaround;
+        const ColumnStats* wt = &r->summary.waiting;
+        fprintf(out, "%ld,%d,%llu,%ld,%ld,%ld,%s,%d,%d,%d,%ld,%.3f,%.4f,%.4f,%ld,%ld,%ld,%ld,"
+                     "%.1f,%.1f,%ld,%ld,%ld,%ld,%.1f,%ld,%ld,%ld,%.4f\n",
+                i, r->replica, r->seed, r->quantum, r->frames, r->cores, disk_name(r->disk),
+                r->finished, r->rejected, r->stalled, r->makespan, r->throughput, r->cpu_util, r->disk_util,
+                r->page_faults, r->disk_ios, r->context_switches, r->events,
+                t->avg, t->stddev, t->p50, t->p95, t->p99, t->max, wt->avg, wt->p50, wt->p95, wt->p99,
+                r->summary.fairness);
+    }
+}
+
+int simulate_sweep(const SweepConfig* cfg, const char* csv_path) {
+    printf("\n## Parameter Sweep ##\n");
+    long runs = sweep_total_runs(cfg);
+    if (runs < 0) {
+        printf("Sweep must have between 1 and %d runs (this one has more).\n", SWEEP_MAX_RUNS);
+        return -1;
+    }
+    if (runs == 0 || cfg->num_programs <= 0) {
+        printf("Sweep must have between 1 and %d runs (this one has none).\n", SWEEP_MAX_RUNS);
+        return -1;
+    }
+    if (cfg->frames.lo < 1 || cfg->frames.hi > MAX_FRAMES || cfg->quantum.lo < 1 || cfg->cores.lo < 1) {
+        printf("Frames must be 1..%d; quantum and cores must be positive.\n", MAX_FRAMES);
+        return -1;
+    }
+    Sweep s = {cfg, NULL, sweep_range_count(&cfg->quantum), sweep_range_count(&cfg->frames),
+               sweep_range_count(&cfg->cores)};
+    s.results = calloc((size_t)runs, sizeof(SweepResult));
+    if (s.results == NULL) {
+        printf("Out of memory for %ld results.\n", runs);
+        return -1;
+    }
+    FILE* out = fopen(csv_path, "w");
+    if (out == NULL) {
+        printf("Cannot open '%s' for writing.\n", csv_path);
+        free(s.results);
+        return -1;
+    }
+    printf("Configurations: %ld quantum x %ld frames x %ld cores x %d disk | Replicas: %d | Processes per run: %d\n",
+           s.num_quantum, s.num_frames, s.num_cores, cfg->num_disks, cfg->replicas, cfg->processes);
+
+    int saved_verbose = sim_verbose;
+    sim_verbose = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int threads = 0;
+    long steals = threadpool_run(cfg->threads, runs, sweep_task, &s, &threads);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sim_verbose = saved_verbose;
+    double seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    if (steals < 0) {
+        printf("Could not start any worker threads.\n");
+        free(s.results);
+        fclose(out);
+        return -1;
+    }
+
+    write_csv(out, s.results, runs);
+    fclose(out);
+
+    // Best configuration by p99 turnaround, averaged over its replicas
+    long best = -1;
+    double best_p99 = 0;
+    long events = 0;
+    for (long i = 0; i < runs; i++) events += s.results[i].events;
+    for (long base = 0; base < runs; base += cfg->replicas) {
+        double p99 = 0;
+        int complete = 1;
+        for (int k = 0; k < cfg->replicas; k++) {
+            p99 += s.results[base + k].summary.turnaround.p99;
+            if (s.results[base + k].rejected > 0 || s.results[base + k].stalled > 0) complete = 0;
+        }
+        p99 /= cfg->replicas;
+        if (complete && (best == -1 || p99 < best_p99)) {
+            best = base;
+            best_p99 = p99;
+        }
+    }
+    printf("Sweep: %ld runs on %d threads in %.3f s (%.0f runs/s, %.0f events/s, %ld steals)\n",
+           runs, threads, seconds, seconds > 0 ? runs / seconds : 0.0,
+           seconds > 0 ? events / seconds : 0.0, steals);
+    if (best >= 0) {
+        const SweepResult* b = &s.results[best];
+        printf("Best p99 turnaround: quantum=%ldus frames=%ld cores=%ld disk=%s -> %.0fus (mean of %d replicas)\n",
+               b->quantum, b->frames, b->cores, disk_name(b->disk), best_p99, cfg->replicas);
+    }
+    printf("Results written to %s\n", csv_path);
+    free(s.results);
+    return 0;
+}
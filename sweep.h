@@ -0,0 +1,44 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "procsim.h"
+
+#define SWEEP_MAX_RUNS 1000000
+
+// Values lo, lo+step, ... up to hi; with 'geometric' set, lo, lo*step, ...
+typedef struct {
+    long lo;
+    long hi;
+    long step;
+    int geometric;
+} SweepRange;
+
+typedef struct {
+    SweepRange quantum;     // Round-robin time slice, us
+    SweepRange frames;      // Physical frames (1..MAX_FRAMES)
+    SweepRange cores;
+    int disks[2];           // SIM_DISK_FCFS and/or SIM_DISK_ELEVATOR
+    int num_disks;
+    int replicas;           // Runs per configuration, each on its own workload seed
+    int processes;          // Programs arriving per run
+    long mean_gap;          // Mean gap between arrivals, us
+    int workload;           // WORKLOAD_* kind picking programs and gaps
+    unsigned long long seed;
+    int threads;
+    const SimProgram* programs;
+    int num_programs;
+} SweepConfig;
+
+void sweep_default_config(SweepConfig* cfg, const SimProgram* programs, int num_programs);
+// Parses "v", "lo..hi", "lo..hi:step" or "lo..hi*factor". Returns -1 if
+// malformed or if the range has more than SWEEP_MAX_RUNS values.
+int sweep_parse_range(const char* text, SweepRange* r);
+long sweep_range_count(const SweepRange* r);
+// Total runs: the product of the range sizes, times the replicas. Returns -1
+// once the product passes SWEEP_MAX_RUNS.
+long sweep_total_runs(const SweepConfig* cfg);
+// Runs every configuration on the thread pool, writes one CSV row per run
+// (in run order, whatever thread ran it) and prints a summary.
+int simulate_sweep(const SweepConfig* cfg, const char* csv_path);
+
+#endif // SWEEP_H
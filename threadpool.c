@@ -0,0 +1,118 @@
+/**
+ * threadpool.c
+ * Work-stealing pool for batches of independent tasks. Each worker starts
+ * with a contiguous share of the task indices and takes from its front. A
+ * worker that runs dry steals the back half of another worker's remaining
+ * range, so uneven task lengths still keep every thread busy. A range is
+ * guarded by its own mutex and no thread holds two at once.
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+typedef struct {
+    pthread_mutex_t lock;
+    long next;   // Owner takes from here
+    long end;    // Thieves take from here
+} PoolRange;
+
+typedef struct {
+    PoolRange* ranges;
+    int num_threads;
+    PoolTaskFn fn;
+    void* ctx;
+    long steals;
+} Pool;
+
+typedef struct {
+    Pool* pool;
+    int id;
+} PoolWorker;
+
+static int take_own(PoolRange* r, long* task) {
+    int ok = 0;
+    pthread_mutex_lock(&r->lock);
+    if (r->next < r->end) {
+        *task = r->next++;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&r->lock);
+    return ok;
+}
+
+// Moves the back half of some other worker's range into this worker's (empty) range.
+static int steal(Pool* pool, int self) {
+    for (int k = 1; k < pool->num_threads; k++) {
+        PoolRange* victim = &pool->ranges[(self + k) % pool->num_threads];
+        long lo = 0, hi = 0;
+        pthread_mutex_lock(&victim->lock);
+        long remaining = victim->end - victim->next;
+        if (remaining > 0) {
+            hi = victim->end;
+            lo = hi - (remaining + 1) / 2;
+            victim->end = lo;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (hi > lo) {
+            PoolRange* own = &pool->ranges[self];
+            pthread_mutex_lock(&own->lock);
+            own->next = lo;
+            own->end = hi;
+            pthread_mutex_unlock(&own->lock);
+            __atomic_fetch_add(&pool->steals, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void* worker_main(void* arg) {
+    PoolWorker* w = arg;
+    Pool* pool = w->pool;
+    long task;
+    while (1) {
+        if (take_own(&pool->ranges[w->id], &task)) {
+            pool->fn(pool->ctx, task, w->id);
+        } else if (!steal(pool, w->id)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+long threadpool_run(int num_threads, long num_tasks, PoolTaskFn fn, void* ctx, int* threads_used) {
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > POOL_MAX_THREADS) num_threads = POOL_MAX_THREADS;
+    if (num_tasks < num_threads) num_threads = num_tasks > 0 ? (int)num_tasks : 1;
+
+    Pool pool = {NULL, num_threads, fn, ctx, 0};
+    PoolRange ranges[POOL_MAX_THREADS];
+    PoolWorker workers[POOL_MAX_THREADS];
+    pthread_t threads[POOL_MAX_THREADS];
+    pool.ranges = ranges;
+    for (int i = 0; i < num_threads; i++) {
+        pthread_mutex_init(&ranges[i].lock, NULL);
+        ranges[i].next = num_tasks * i / num_threads;
+        ranges[i].end = num_tasks * (i + 1) / num_threads;
+        workers[i].pool = &pool;
+        workers[i].id = i;
+    }
+
+    int started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (pthread_create(&threads[i], NULL, worker_main, &workers[i]) != 0) break;
+        started++;
+    }
+    // Workers that failed to start leave their ranges to be stolen
+    for (int i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    for (int i = 0; i < num_threads; i++) pthread_mutex_destroy(&ranges[i].lock);
+    if (threads_used) *threads_used = started;
+    return started > 0 ? pool.steals : -1;
+}
+
+int threadpool_default_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) return 1;
+    return n > POOL_MAX_THREADS ? POOL_MAX_THREADS : (int)n;
+}
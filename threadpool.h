@@ -0,0 +1,17 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#define POOL_MAX_THREADS 64
+
+// Runs one task; 'worker' is the index of the thread running it.
+typedef void (*PoolTaskFn)(void* ctx, long task, int worker);
+
+// Runs fn(ctx, i, worker) for every i in [0, num_tasks) on num_threads new
+// threads and waits for them all. Never starts more threads than tasks;
+// threads_used (optional) receives how many actually ran. Returns the number
+// of steals, or -1 if no thread could be started.
+long threadpool_run(int num_threads, long num_tasks, PoolTaskFn fn, void* ctx, int* threads_used);
+// Online CPUs, clamped to 1..POOL_MAX_THREADS.
+int threadpool_default_threads(void);
+
+#endif // THREADPOOL_H
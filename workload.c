@@ -0,0 +1,86 @@
+/**
+ * workload.c
+ * Seeded synthetic workload generators shared by the benchmarks: uniform,
+ * sequential, Zipf (Gray et al.'s constant-time sampler) and bursty.
+ */
+#include <math.h>
+#include "workload.h"
+
+static const char* workload_names[WORKLOAD_KINDS] = {"uniform", "sequential", "zipf", "bursty"};
+
+const char* workload_name(int kind) {
+    return (kind >= 0 && kind < WORKLOAD_KINDS) ? workload_names[kind] : "unknown";
+}
+
+void workload_init(Workload* w, int kind, int range, unsigned long long seed) {
+    w->kind = kind;
+    w->range = range > 0 ? range : 1;
+    w->state = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    w->next_seq = 0;
+    w->run_left = 0;
+    w->gap_count = 0;
+    w->zipf_zetan = w->zipf_alpha = w->zipf_eta = 0;
+
+    if (kind == WORKLOAD_ZIPF) {
+        double theta = WORKLOAD_ZIPF_THETA;
+        double zetan = 0;
+        for (int i = 1; i <= w->range; i++) zetan += 1.0 / pow((double)i, theta);
+        double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+        w->zipf_zetan = zetan;
+        w->zipf_alpha = 1.0 / (1.0 - theta);
+        w->zipf_eta = (1.0 - pow(2.0 / w->range, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+}
+
+// splitmix64: small, fast and good enough for workload shaping
+unsigned long long workload_rand(Workload* w) {
+    unsigned long long z = (w->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static double workload_uniform01(Workload* w) {
+    return (workload_rand(w) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int workload_next_key(Workload* w) {
+    switch (w->kind) {
+    case WORKLOAD_SEQUENTIAL: {
+        int key = w->next_seq;
+        w->next_seq = (w->next_seq + 1) % w->range;
+        return key;
+    }
+    case WORKLOAD_ZIPF: {
+        double u = workload_uniform01(w);
+        double uz = u * w->zipf_zetan;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + pow(0.5, WORKLOAD_ZIPF_THETA)) return w->range > 1 ? 1 : 0;
+        int key = (int)(w->range * pow(w->zipf_eta * u - w->zipf_eta + 1.0, w->zipf_alpha));
+        return key < w->range ? key : w->range - 1;
+    }
+    case WORKLOAD_BURSTY:
+        if (w->run_left == 0) {
+            w->next_seq = (int)(workload_rand(w) % (unsigned long long)w->range);
+            w->run_left = 1 + (int)(workload_rand(w) % (2 * WORKLOAD_BURST_LEN));
+        }
+        w->run_left--;
+        {
+            int key = w->next_seq;
+            w->next_seq = (w->next_seq + 1) % w->range;
+            return key;
+        }
+    default:
+        return (int)(workload_rand(w) % (unsigned long long)w->range);
+    }
+}
+
+long workload_next_gap(Workload* w, long mean_gap) {
+    double mean = (double)mean_gap;
+    if (w->kind == WORKLOAD_BURSTY) {
+        // Tight gaps inside a burst, one long gap between bursts; same overall mean
+        int in_burst = (w->gap_count++ % WORKLOAD_BURST_LEN) != 0;
+        mean = in_burst ? mean * 0.1 : mean * (WORKLOAD_BURST_LEN - 0.1 * (WORKLOAD_BURST_LEN - 1));
+    }
+    return (long)(-mean * log(1.0 - workload_uniform01(w)));
+}
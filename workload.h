@@ -0,0 +1,32 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#define WORKLOAD_UNIFORM    0 // Every key equally likely
+#define WORKLOAD_SEQUENTIAL 1 // 0, 1, 2, ... wrapping at the range
+#define WORKLOAD_ZIPF       2 // A few hot keys take most of the accesses
+#define WORKLOAD_BURSTY     3 // Sequential runs at random offsets, arriving in bursts
+#define WORKLOAD_KINDS      4
+
+#define WORKLOAD_ZIPF_THETA 0.99
+#define WORKLOAD_BURST_LEN 16
+
+// Seeded generator of keys in [0, range) and inter-arrival gaps. The same
+// kind, range and seed always produce the same sequence.
+typedef struct {
+    int kind;
+    int range;
+    unsigned long long state;
+    int next_seq;   // Sequential cursor, also the current bursty run position
+    int run_left;   // Keys left in the current bursty run
+    int gap_count;  // Arrivals so far, bursty gaps come in groups of WORKLOAD_BURST_LEN
+    double zipf_zetan, zipf_alpha, zipf_eta; // Precomputed constants for Zipf sampling
+} Workload;
+
+void workload_init(Workload* w, int kind, int range, unsigned long long seed);
+unsigned long long workload_rand(Workload* w);
+int workload_next_key(Workload* w);
+// Gap before the next arrival; mean_gap is the long-run average for every kind.
+long workload_next_gap(Workload* w, long mean_gap);
+const char* workload_name(int kind);
+
+#endif // WORKLOAD_H